@@ -0,0 +1,74 @@
+import subprocess
+import statistics
+import sys
+import time
+
+# Wall-clock time of the fixed-size router kernels (RouterKernel.hh) against
+# the generic ones, on the router shapes production runs use.  Both kernels
+# must print exactly the same results.
+
+garnet_bin = "./garnet_standalone"
+num_runs = 5
+
+benchmarks = [
+    {
+        "name": "Mesh 8x8, 2 VC/vnet",
+        "args": ["--rows", "8", "--cols", "8", "--rate", "0.3",
+                 "--packet-size", "5", "--cycles", "10000",
+                 "--vcs-per-vnet", "2"]
+    },
+    {
+        "name": "Mesh 8x8, 4 VC/vnet",
+        "args": ["--rows", "8", "--cols", "8", "--rate", "0.3",
+                 "--packet-size", "5", "--cycles", "10000",
+                 "--vcs-per-vnet", "4"]
+    },
+    {
+        "name": "Mesh 4x4, 3 VC/vnet",
+        "args": ["--rows", "4", "--cols", "4", "--rate", "0.3",
+                 "--packet-size", "5", "--cycles", "20000",
+                 "--vcs-per-vnet", "3"]
+    },
+    {
+        "name": "Mesh 16x16, 2 VC/vnet",
+        "args": ["--rows", "16", "--cols", "16", "--rate", "0.1",
+                 "--packet-size", "3", "--cycles", "5000",
+                 "--vcs-per-vnet", "2"]
+    },
+]
+
+
+def run(args, kernel):
+    cmd = [garnet_bin] + args + ["--router-kernel", kernel]
+    start = time.perf_counter()
+    result = subprocess.run(cmd, capture_output=True, text=True, check=True)
+    return time.perf_counter() - start, result.stdout
+
+
+print(f"{'Benchmark':<24} | {'Generic (s)':<12} | {'Fixed (s)':<12} | {'Speedup':<8}")
+print("-" * 66)
+
+mismatches = []
+for bench in benchmarks:
+    times = {"generic": [], "fixed": []}
+    outputs = {}
+    # Alternate the kernels so drift in machine load hits both alike.
+    for i in range(num_runs):
+        for kernel in ("generic", "fixed"):
+            elapsed, output = run(bench["args"], kernel)
+            times[kernel].append(elapsed)
+            outputs[kernel] = output
+    if outputs["generic"] != outputs["fixed"]:
+        mismatches.append(bench["name"])
+
+    generic = statistics.median(times["generic"])
+    fixed = statistics.median(times["fixed"])
+    print(f"{bench['name']:<24} | {generic:<12.3f} | {fixed:<12.3f} | "
+          f"{generic / fixed:<8.2f}")
+
+print("-" * 66)
+print(f"Median of {num_runs} runs each.")
+if mismatches:
+    print("ERROR: kernels disagree on: " + ", ".join(mismatches))
+    sys.exit(1)
+print("Both kernels produced identical output.")
@@ -13,6 +13,8 @@ Tests verify:
   8. Zero-lambda no-injection
   9. Injection probability scaling across phases
  10. Results-file reproducibility (deterministic RNG)
+ 11. Checkpoint/restore matches an uninterrupted run
+ 12. Sweep results do not depend on --jobs
 """
 
 import json
@@ -709,6 +711,125 @@ def test_link_utilization_reported():
         f"num_links={num_links} avg_util={avg_util:.4f} max_util={max_util:.4f}")
 
 
+def test_checkpoint_restore_matches_uninterrupted():
+    """
+    A run restored from a mid-simulation checkpoint must write the same
+    results file, byte for byte, as the run that took the checkpoint.
+    The checkpoint falls inside phase 1 so the restore has to carry the
+    phase counters, MSHRs and in-flight packets across.
+    """
+    name = "Checkpoint/Restore Matches Uninterrupted Run"
+
+    phases = [
+        _make_phase(0, 600, 0.05, num_cpus=4, num_dirs=4),
+        _make_phase(1, 600, 0.03, num_cpus=4, num_dirs=4),
+    ]
+    profile = _make_profile(4, 4, 4, 4, phases)
+    ppath = _write_profile(profile)
+
+    outs = []
+    for _ in range(2):
+        tf = tempfile.NamedTemporaryFile(suffix=".json", delete=False)
+        tf.close()
+        outs.append(tf.name)
+    ckpt = outs[0][:-len(".json")] + ".ckpt"
+
+    rc1, out1, err1, res1 = _run_pace(ppath, output_path=outs[0],
+                                      extra_args=["--seed", "7",
+                                                  "--checkpoint-every", "900",
+                                                  "--checkpoint-file", ckpt])
+    rc2, out2, err2, res2 = None, "", "", None
+    if rc1 == 0 and os.path.isfile(ckpt):
+        rc2, out2, err2, res2 = _run_pace(ppath, output_path=outs[1],
+                                          extra_args=["--seed", "7",
+                                                      "--restore", ckpt])
+
+    same = False
+    if res1 is not None and res2 is not None:
+        with open(outs[0], "rb") as a, open(outs[1], "rb") as b:
+            same = a.read() == b.read()
+
+    os.unlink(ppath)
+    for path in outs + [ckpt]:
+        if os.path.isfile(path):
+            os.unlink(path)
+
+    if rc1 != 0:
+        return TestResult(name, False, f"Checkpointing run crashed: {err1[:300]}")
+    if "Checkpoint at cycle 900" not in out1:
+        return TestResult(name, False, "No checkpoint written at cycle 900")
+    if rc2 is None:
+        return TestResult(name, False, f"Checkpoint file {ckpt} missing")
+    if rc2 != 0:
+        return TestResult(name, False, f"Restored run failed: {err2[:300]}")
+    if "Restored checkpoint" not in out2:
+        return TestResult(name, False, "Restored run did not report the restore")
+    if res1 is None or res2 is None:
+        return TestResult(name, False, "Results missing for one or both runs")
+    if not same:
+        rx1 = res1["packet_stats"]["total_packets_received"]
+        rx2 = res2["packet_stats"]["total_packets_received"]
+        return TestResult(name, False,
+            f"Results differ after restore: rx_uninterrupted={rx1} rx_restored={rx2}")
+
+    return TestResult(name, True,
+        f"rx={res1['packet_stats']['total_packets_received']} "
+        f"results identical after restore at cycle 900")
+
+
+def test_sweep_independent_of_jobs():
+    """
+    A sweep run with --jobs 3 must write byte-identical result files to
+    the same sweep run one point at a time, for PACE and --uniform sweeps.
+    """
+    name = "Sweep results independent of --jobs"
+
+    phase = _make_phase(0, 500, 0.04, num_cpus=4, num_dirs=4)
+    profile = _make_profile(4, 4, 4, 4, [phase])
+    ppath = _write_profile(profile)
+
+    try:
+        checked = 0
+        for mode in ([], ["--uniform"]):
+            with tempfile.TemporaryDirectory() as tmp:
+                files = {}
+                for jobs in ["1", "3"]:
+                    out_dir = os.path.join(tmp, "jobs" + jobs)
+                    os.mkdir(out_dir)
+                    rc, _, err = _run([
+                        "--topology", "Mesh_XY",
+                        "--rows", "4", "--cols", "4",
+                        "--routing", "1",
+                        "--pace-profile", ppath,
+                        "--pace-output", os.path.join(out_dir, "s.json"),
+                        "--sweep-lambda-range", "0.5:1.5:0.5",
+                        "--seeds", "2",
+                        "--cycles", "500",
+                        "--jobs", jobs,
+                    ] + mode)
+                    if rc != 0:
+                        return TestResult(name, False,
+                            f"--jobs {jobs} {' '.join(mode)} crashed (rc={rc}): {err[:200]}")
+                    files[jobs] = {}
+                    for fname in sorted(os.listdir(out_dir)):
+                        with open(os.path.join(out_dir, fname)) as f:
+                            files[jobs][fname] = f.read()
+
+                if sorted(files["1"]) != sorted(files["3"]):
+                    return TestResult(name, False,
+                        f"Different result files: {sorted(files['1'])} vs {sorted(files['3'])}")
+                for fname in files["1"]:
+                    if files["1"][fname] != files["3"][fname]:
+                        return TestResult(name, False,
+                            f"{fname} differs between --jobs 1 and --jobs 3 {' '.join(mode)}")
+                checked += len(files["1"])
+    finally:
+        os.unlink(ppath)
+
+    return TestResult(name, True,
+        f"{checked} result files identical with --jobs 1 and 3 (PACE and --uniform)")
+
+
 # ---------------------------------------------------------------------------
 # Main
 # ---------------------------------------------------------------------------
@@ -734,6 +855,8 @@ def main():
         test_injection_rate_scales_with_lambda,
         test_deterministic_rng,
         test_link_utilization_reported,
+        test_checkpoint_restore_matches_uninterrupted,
+        test_sweep_independent_of_jobs,
     ]
 
     results = []
@@ -1,7 +1,9 @@
+import json
 import subprocess
 import re
 import sys
 import os
+import tempfile
 
 # Configuration
 BINARY = "./garnet_standalone"
@@ -110,6 +112,255 @@ def run_3d_path_test():
     except Exception as e:
         return TestResult(name, False, str(e))
 
+def run_rng_known_answer_test():
+    name = "CounterRng Known Answer (Philox4x32-10)"
+    # Random123's kat_vectors: key 0, counter 0.  Built against the header
+    # directly so the simulator itself never pays for the check.
+    expected = "6627e8d5 e169c58d bc57ac4c 9b00dbd8"
+    source = (
+        '#include "CounterRng.hh"\n'
+        '#include <cstdio>\n'
+        'int main() {\n'
+        '    uint32_t out[4];\n'
+        '    garnet::CounterRng(0, 0, 0).block(0, out);\n'
+        '    std::printf("%08x %08x %08x %08x\\n", out[0], out[1], out[2], out[3]);\n'
+        '}\n')
+    print(f"Running Test: {name}...")
+
+    try:
+        with tempfile.TemporaryDirectory() as tmp:
+            src = os.path.join(tmp, "kat.cc")
+            exe = os.path.join(tmp, "kat")
+            with open(src, "w") as f:
+                f.write(source)
+            build = subprocess.run([os.environ.get("CXX", "g++"), "-std=c++11", "-O3",
+                                    "-Isrc", src, "-o", exe],
+                                   capture_output=True, text=True, timeout=TIMEOUT)
+            if build.returncode != 0:
+                return TestResult(name, False, "Build failed\n" + build.stderr)
+            output = subprocess.run([exe], capture_output=True, text=True,
+                                    timeout=TIMEOUT).stdout.strip()
+
+        if output == expected:
+            return TestResult(name, True, f"Block 0 = {output}")
+        return TestResult(name, False, f"Block 0 = {output}, expected {expected}")
+
+    except Exception as e:
+        return TestResult(name, False, str(e))
+
+def run_kernel_equivalence_test():
+    name = "Kernel/Thread Equivalence (sweep|activity|phased x 1|4 threads)"
+    # Every kernel and every thread count must report the same statistics.
+    args = ["--topology", "Mesh_XY", "--rows", "4", "--cols", "4", "--cycles", "3000",
+            "--rate", "0.3", "--packet-size", "4"]
+    print(f"Running Test: {name}...")
+
+    try:
+        reference = None
+        for kernel in ["sweep", "activity", "phased"]:
+            for threads in ["1", "4"]:
+                cmd = [BINARY] + args + ["--kernel", kernel, "--threads", threads]
+                print(f"  Command: {' '.join(cmd)}")
+                result = subprocess.run(cmd, capture_output=True, text=True, timeout=TIMEOUT)
+                if result.returncode != 0:
+                    return TestResult(name, False, f"Crashed with code {result.returncode}")
+                stats = [l for l in result.stdout.splitlines() if l.startswith("  ")]
+                if not stats:
+                    return TestResult(name, False, f"No statistics from --kernel {kernel}")
+                if reference is None:
+                    reference = stats
+                elif stats != reference:
+                    return TestResult(name, False,
+                                      f"--kernel {kernel} --threads {threads} differs from "
+                                      "--kernel sweep --threads 1")
+        return TestResult(name, True, "6 runs, identical statistics")
+
+    except Exception as e:
+        return TestResult(name, False, str(e))
+
+def run_saturation_search_test():
+    name = "Saturation Search (4x4 Mesh)"
+    print(f"Running Test: {name}...")
+
+    try:
+        with tempfile.TemporaryDirectory() as tmp:
+            cmd = [BINARY, "--topology", "Mesh_XY", "--rows", "4", "--cols", "4",
+                   "--cycles", "2000", "--rate", "0.1", "--find-saturation",
+                   "--pace-output", os.path.join(tmp, "sat.json")]
+            print(f"  Command: {' '.join(cmd)}")
+            result = subprocess.run(cmd, capture_output=True, text=True, timeout=TIMEOUT)
+            if result.returncode != 0:
+                return TestResult(name, False, f"Crashed with code {result.returncode}")
+            with open(os.path.join(tmp, "sat_saturation.json")) as f:
+                sat = json.load(f)
+
+        if not sat["saturated"]:
+            return TestResult(name, False, "No saturation found")
+        zero_load = sat["zero_load_latency"]
+        mult, diverged = sat["saturation_lambda_mult"], sat["diverged_lambda_mult"]
+        probes = {p["lambda_mult"]: p for p in sat["probes"]}
+        # Bisected to within 2%, between a stable and a diverging probe.
+        if not (mult < diverged <= mult * 1.02 + 1e-9):
+            return TestResult(name, False, f"Bracket [{mult}, {diverged}] wider than 2%")
+        if probes[mult]["diverged"] or not probes[diverged]["diverged"]:
+            return TestResult(name, False, "Bracket probes do not straddle saturation")
+        # The knee is where the latency reaches 2x zero load, below
+        # saturation; if it never does, it is the saturation point itself.
+        knee, knee_latency = sat["knee_lambda_mult"], sat["knee_latency"]
+        if not (knee <= mult and knee_latency <= 2.0 * zero_load + 1e-6):
+            return TestResult(name, False,
+                              f"Knee at {knee} with latency {knee_latency:.2f} "
+                              f"(zero load {zero_load:.2f})")
+        if knee_latency < 2.0 * zero_load - 1e-6 and knee != mult:
+            return TestResult(name, False, f"Knee at {knee} below 2x zero load but not at saturation")
+        return TestResult(name, True,
+                          f"Saturates at lambda_mult {mult}, knee at "
+                          f"{sat['knee_lambda_mult']} ({sat['knee_latency']:.2f} cycles, "
+                          f"zero load {zero_load:.2f})")
+
+    except Exception as e:
+        return TestResult(name, False, str(e))
+
+def run_ci_target_test():
+    name = "CI Target Early Stop (--ci-target 0.02)"
+    args = ["--topology", "Mesh_XY", "--rows", "4", "--cols", "4", "--cycles", "50000",
+            "--rate", "0.1", "--batch-cycles", "500"]
+    print(f"Running Test: {name}...")
+
+    try:
+        runs = {}
+        for target in ["0.02", "0"]:
+            cmd = [BINARY] + args + ["--ci-target", target]
+            print(f"  Command: {' '.join(cmd)}")
+            result = subprocess.run(cmd, capture_output=True, text=True, timeout=TIMEOUT)
+            if result.returncode != 0:
+                return TestResult(name, False, f"Crashed with code {result.returncode}")
+            ci = re.search(r"Latency 95% CI: \+/- [\d.e+-]+ cycles \(([\d.e+-]+) % of (\d+) batch means\)",
+                           result.stdout)
+            if not ci:
+                return TestResult(name, False, f"No confidence interval reported with --ci-target {target}")
+            runs[target] = (float(ci.group(1)), int(ci.group(2)))
+
+        pct, batches = runs["0.02"]
+        full_batches = runs["0"][1]
+        if full_batches != 100:
+            return TestResult(name, False, f"Full window ran {full_batches} batches, expected 100")
+        if not (10 <= batches < full_batches):
+            return TestResult(name, False, f"Stopped after {batches} batches")
+        if pct > 2.0:
+            return TestResult(name, False, f"Stopped at a {pct}% interval, above the 2% target")
+        return TestResult(name, True, f"Stopped after {batches} of {full_batches} batches at +/- {pct}%")
+
+    except Exception as e:
+        return TestResult(name, False, str(e))
+
+def run_chiplet_lookahead_test():
+    name = "Chiplet Lookahead (4 threads, 3-cycle windows)"
+    # Only inter-chiplet links cross partitions, so their latency is the
+    # window length, and splitting must not change the results.
+    args = ["--topology", "PACE_Chiplet", "--num-chiplets", "4", "--intra-rows", "2",
+            "--intra-cols", "2", "--inter-latency", "3", "--cycles", "2000", "--rate", "0.1"]
+    print(f"Running Test: {name}...")
+
+    try:
+        outputs = []
+        for threads in ["1", "4"]:
+            cmd = [BINARY] + args + ["--threads", threads]
+            print(f"  Command: {' '.join(cmd)}")
+            result = subprocess.run(cmd, capture_output=True, text=True, timeout=TIMEOUT)
+            if result.returncode != 0:
+                return TestResult(name, False, f"Crashed with code {result.returncode}")
+            outputs.append(result.stdout)
+
+        windows = re.search(r"SimKernel: (\d+) partitions, (\d+)-cycle windows", outputs[1])
+        if not windows:
+            return TestResult(name, False, "No partitions reported")
+        if windows.group(2) != "3":
+            return TestResult(name, False, f"{windows.group(2)}-cycle windows, expected 3")
+
+        def stats(output):
+            return [l for l in output.splitlines() if l.startswith("  - ")]
+        if stats(outputs[0]) != stats(outputs[1]):
+            return TestResult(name, False, "Statistics differ from the 1-thread run")
+        return TestResult(name, True, f"{windows.group(1)} partitions, 3-cycle windows, same statistics")
+
+    except Exception as e:
+        return TestResult(name, False, str(e))
+
+def run_pool_balance_test():
+    name = "FlitPool Cross-Thread Balance"
+    # One thread allocates, another frees: the pool must recycle the freed
+    # slots instead of allocating new slabs for ever.
+    source = (
+        '#include "FlitPool.hh"\n'
+        '#include <condition_variable>\n'
+        '#include <cstdio>\n'
+        '#include <mutex>\n'
+        '#include <thread>\n'
+        '#include <vector>\n'
+        'using garnet::FlitPool;\n'
+        'std::mutex lock;\n'
+        'std::condition_variable cv;\n'
+        'std::vector<void*> mailbox;\n'
+        'bool done = false;\n'
+        'int main() {\n'
+        '    std::thread consumer([] {\n'
+        '        for (;;) {\n'
+        '            std::vector<void*> batch;\n'
+        '            {\n'
+        '                std::unique_lock<std::mutex> l(lock);\n'
+        '                cv.wait(l, [] { return !mailbox.empty() || done; });\n'
+        '                if (mailbox.empty()) return;\n'
+        '                batch.swap(mailbox);\n'
+        '            }\n'
+        '            cv.notify_all();\n'
+        '            for (void* p : batch) FlitPool::release(p, 64);\n'
+        '        }\n'
+        '    });\n'
+        '    unsigned long long warm = 0;\n'
+        '    for (int round = 0; round < 2000; ++round) {\n'
+        '        std::vector<void*> batch;\n'
+        '        for (int i = 0; i < 1000; ++i)\n'
+        '            batch.push_back(FlitPool::allocate(64));\n'
+        '        std::unique_lock<std::mutex> l(lock);\n'
+        '        cv.wait(l, [] { return mailbox.empty(); });\n'
+        '        mailbox.swap(batch);\n'
+        '        cv.notify_all();\n'
+        '        if (round == 100) warm = FlitPool::counters().slabs;\n'
+        '    }\n'
+        '    {\n'
+        '        std::lock_guard<std::mutex> l(lock);\n'
+        '        done = true;\n'
+        '    }\n'
+        '    cv.notify_all();\n'
+        '    consumer.join();\n'
+        '    std::printf("%llu %llu\\n", warm,\n'
+        '                (unsigned long long)FlitPool::counters().slabs);\n'
+        '}\n')
+    print(f"Running Test: {name}...")
+
+    try:
+        with tempfile.TemporaryDirectory() as tmp:
+            src = os.path.join(tmp, "pool.cc")
+            exe = os.path.join(tmp, "pool")
+            with open(src, "w") as f:
+                f.write(source)
+            build = subprocess.run([os.environ.get("CXX", "g++"), "-std=c++11", "-O3",
+                                    "-pthread", "-DGARNET_POOL_DEBUG", "-Isrc", src,
+                                    "src/FlitPool.cc", "-o", exe],
+                                   capture_output=True, text=True, timeout=TIMEOUT)
+            if build.returncode != 0:
+                return TestResult(name, False, "Build failed\n" + build.stderr)
+            output = subprocess.run([exe], capture_output=True, text=True,
+                                    timeout=TIMEOUT).stdout.split()
+
+        warm, final = int(output[0]), int(output[1])
+        details = f"{warm} slabs after warm-up, {final} at the end"
+        return TestResult(name, final == warm, details)
+
+    except Exception as e:
+        return TestResult(name, False, str(e))
+
 def main():
     tests = [
         # 1. Smoke Test (Basic Connectivity)
@@ -189,6 +440,36 @@ def main():
     results.append(path_3d_res)
     print(f"  Result: {'PASS' if path_3d_res.success else 'FAIL'} ({path_3d_res.details})\n")
 
+    # Run RNG Known-Answer Test
+    kat_res = run_rng_known_answer_test()
+    results.append(kat_res)
+    print(f"  Result: {'PASS' if kat_res.success else 'FAIL'} ({kat_res.details})\n")
+
+    # Run Kernel/Thread Equivalence Test
+    kernel_res = run_kernel_equivalence_test()
+    results.append(kernel_res)
+    print(f"  Result: {'PASS' if kernel_res.success else 'FAIL'} ({kernel_res.details})\n")
+
+    # Run Saturation Search Test
+    sat_res = run_saturation_search_test()
+    results.append(sat_res)
+    print(f"  Result: {'PASS' if sat_res.success else 'FAIL'} ({sat_res.details})\n")
+
+    # Run CI Target Test
+    ci_res = run_ci_target_test()
+    results.append(ci_res)
+    print(f"  Result: {'PASS' if ci_res.success else 'FAIL'} ({ci_res.details})\n")
+
+    # Run Chiplet Lookahead Test
+    lookahead_res = run_chiplet_lookahead_test()
+    results.append(lookahead_res)
+    print(f"  Result: {'PASS' if lookahead_res.success else 'FAIL'} ({lookahead_res.details})\n")
+
+    # Run FlitPool Balance Test
+    pool_res = run_pool_balance_test()
+    results.append(pool_res)
+    print(f"  Result: {'PASS' if pool_res.success else 'FAIL'} ({pool_res.details})\n")
+
     for t in tests:
         res = run_test(t["name"], t["args"], t.get("min_pkts", 0), t.get("max_lat"))
         results.append(res)
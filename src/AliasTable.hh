@@ -0,0 +1,89 @@
+// Walker's alias method (Vose's construction, "A linear algorithm for
+// generating random numbers with a given distribution", IEEE TSE 1991).
+//
+// Sampling an index from n weights takes one uniform draw and one table
+// entry, whatever n is: the draw picks column floor(u * n), and its
+// fractional part picks between the column's own index and its alias.
+// Building the table is O(n) and happens once per distribution, at load
+// time.
+
+#ifndef __GARNET_ALIAS_TABLE_HH__
+#define __GARNET_ALIAS_TABLE_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace garnet {
+
+class AliasTable {
+public:
+    struct Column {
+        double   prob;     // chance of keeping the column's own index
+        uint32_t alias;
+    };
+
+    AliasTable() {}
+    explicit AliasTable(const std::vector<double>& weights) { build(weights); }
+
+    // Weights need not be normalised; negative ones count as zero.  If
+    // they are all zero every index is equally likely.
+    void
+    build(const std::vector<double>& weights)
+    {
+        size_t n = weights.size();
+        m_columns.assign(n, Column{1.0, 0});
+        if (n == 0) return;
+
+        double total = 0.0;
+        for (double w : weights) total += w > 0.0 ? w : 0.0;
+
+        std::vector<double> scaled(n);
+        std::vector<uint32_t> small, large;
+        for (size_t i = 0; i < n; ++i) {
+            double w = weights[i] > 0.0 ? weights[i] : 0.0;
+            scaled[i] = total > 0.0 ? w * n / total : 1.0;
+            (scaled[i] < 1.0 ? small : large).push_back((uint32_t)i);
+            m_columns[i].alias = (uint32_t)i;
+        }
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            m_columns[s].prob = scaled[s];
+            m_columns[s].alias = l;
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // Whatever is left is 1 up to rounding.
+        for (uint32_t i : small) m_columns[i].prob = 1.0;
+        for (uint32_t i : large) m_columns[i].prob = 1.0;
+    }
+
+    size_t size() const { return m_columns.size(); }
+    bool empty() const { return m_columns.empty(); }
+
+    // Index for a uniform draw u in [0, 1).  The table must not be empty.
+    size_t
+    sample(double u) const
+    {
+        double x = u * m_columns.size();
+        size_t i = (size_t)x;
+        if (i >= m_columns.size()) i = m_columns.size() - 1;
+        const Column& c = m_columns[i];
+        return x - i < c.prob ? i : c.alias;
+    }
+
+    // The built table, e.g. to store it, and a stored one taken back.
+    const std::vector<Column>& columns() const { return m_columns; }
+    void assign(std::vector<Column> columns) { m_columns.swap(columns); }
+
+private:
+    std::vector<Column> m_columns;
+};
+
+} // namespace garnet
+
+#endif // __GARNET_ALIAS_TABLE_HH__
@@ -0,0 +1,46 @@
+#include "Arena.hh"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace garnet {
+
+const size_t Arena::kCacheLine;
+const size_t Arena::kMinChunkBytes;
+const size_t Arena::kMaxChunkBytes;
+
+Arena::~Arena()
+{
+    for (size_t i = m_objects.size(); i > 0; --i)
+        m_objects[i - 1].destroy(m_objects[i - 1].first,
+                                 m_objects[i - 1].count);
+}
+
+void* Arena::allocate(size_t size, size_t align)
+{
+    if (!m_chunks.empty()) {
+        Chunk& chunk = m_chunks.back();
+        uintptr_t next = ((uintptr_t)chunk.next + align - 1) & ~(align - 1);
+        if (next + size <= (uintptr_t)chunk.end) {
+            m_used += next + size - (uintptr_t)chunk.next;
+            chunk.next = (char*)(next + size);
+            return (void*)next;
+        }
+    }
+
+    // Each chunk doubles the last one; a chunk starts on a cache line.
+    m_chunk_bytes = m_chunks.empty() ? kMinChunkBytes
+                    : std::min(kMaxChunkBytes, 2 * m_chunk_bytes);
+    size_t bytes = std::max(m_chunk_bytes, size + align);
+    Chunk chunk;
+    chunk.memory.reset(new char[bytes + kCacheLine]);
+    uintptr_t start = ((uintptr_t)chunk.memory.get() + kCacheLine - 1) &
+                      ~(kCacheLine - 1);
+    chunk.next = (char*)start;
+    chunk.end = (char*)start + bytes;
+    m_reserved += bytes + kCacheLine;
+    m_chunks.push_back(std::move(chunk));
+    return allocate(size, align);
+}
+
+} // namespace garnet
@@ -0,0 +1,138 @@
+// Bump allocator for the long-lived objects of one router.
+//
+// A router's units, VCs, crossbar buffers and the links feeding its
+// inports are built at different points of Topology::build(), interleaved
+// with every other router's.  Allocated separately they end up all over
+// the heap; carved from the router's arena they share a few consecutive
+// cache lines, in the order they were created.  Chunks start small and
+// double up to kMaxChunkBytes, so small routers do not reserve much.
+//
+// Objects are never freed one at a time: the arena destroys them in
+// reverse order of creation when it goes away.
+
+#ifndef __GARNET_ARENA_HH__
+#define __GARNET_ARENA_HH__
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace garnet {
+
+class Arena {
+public:
+    static const size_t kCacheLine = 64;
+    static const size_t kMinChunkBytes = 2048;
+    static const size_t kMaxChunkBytes = 65536;
+
+    Arena() {}
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template <typename T, typename... Args>
+    T*
+    create(Args&&... args)
+    {
+        T* obj = new (allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(args)...);
+        remember<T>(obj, 1);
+        return obj;
+    }
+
+    // `count` default-constructed objects in a row.
+    template <typename T>
+    T*
+    create_array(size_t count)
+    {
+        T* objs = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; ++i) new (objs + i) T();
+        remember<T>(objs, count);
+        return objs;
+    }
+
+    // Raw storage, e.g. for containers through ArenaAllocator.  It is
+    // only given back when the arena goes away.
+    void* allocate(size_t size, size_t align);
+
+    // Bytes handed out, including alignment padding, and bytes taken from
+    // the heap.
+    size_t bytes_used() const { return m_used; }
+    size_t bytes_reserved() const { return m_reserved; }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> memory;
+        char* next;
+        char* end;
+    };
+    struct Objects {
+        void* first;
+        size_t count;
+        void (*destroy)(void*, size_t);
+    };
+
+    template <typename T>
+    void
+    remember(T* first, size_t count)
+    {
+        if (std::is_trivially_destructible<T>::value) return;
+        m_objects.push_back({first, count, [](void* p, size_t n) {
+            for (size_t i = n; i > 0; --i) static_cast<T*>(p)[i - 1].~T();
+        }});
+    }
+
+    std::vector<Chunk> m_chunks;
+    std::vector<Objects> m_objects;
+    size_t m_chunk_bytes = 0;      // size the last chunk was meant to have
+    size_t m_used = 0;
+    size_t m_reserved = 0;
+};
+
+// Allocator placing a container's elements in an arena, or on the heap
+// without one.  Containers in the arena are sized once, while the router
+// is built; memory they release stays in the arena.
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    ArenaAllocator(Arena* arena = nullptr) : m_arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.arena()) {}
+
+    T*
+    allocate(size_t n)
+    {
+        if (!m_arena) return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void
+    deallocate(T* p, size_t)
+    {
+        if (!m_arena) ::operator delete(p);
+    }
+
+    Arena* arena() const { return m_arena; }
+
+private:
+    Arena* m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return a.arena() == b.arena();
+}
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return !(a == b);
+}
+
+} // namespace garnet
+
+#endif // __GARNET_ARENA_HH__
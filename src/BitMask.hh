@@ -0,0 +1,103 @@
+// Set of small non-negative integers (VC or port indices) stored as
+// 64-bit words.
+//
+// The allocators keep one per port so that a scan visits only the VCs or
+// ports that have something to do, in the same round-robin order as a
+// scan over all of them.
+
+#ifndef __GARNET_BIT_MASK_HH__
+#define __GARNET_BIT_MASK_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Arena.hh"
+
+namespace garnet {
+
+class BitMask {
+public:
+    BitMask() {}
+    explicit BitMask(int size) { resize(size); }
+    // Words in `arena` (see ArenaAllocator) rather than on the heap.
+    BitMask(int size, Arena* arena) : m_words(arena) { resize(size); }
+
+    // Holds [0, size); clears every member.
+    void resize(int size)
+    {
+        m_size = size;
+        m_words.assign((size + 63) / 64, 0);
+    }
+    int size() const { return m_size; }
+
+    void set(int i)        { m_words[i >> 6] |= bit(i); }
+    void reset(int i)      { m_words[i >> 6] &= ~bit(i); }
+    bool test(int i) const { return (m_words[i >> 6] & bit(i)) != 0; }
+
+    bool any() const
+    {
+        for (uint64_t word : m_words)
+            if (word) return true;
+        return false;
+    }
+
+    void clear()
+    {
+        for (uint64_t& word : m_words) word = 0;
+    }
+
+    // Smallest member >= i, or -1.
+    int find_next(int i) const
+    {
+        if (i >= m_size) return -1;
+        size_t w = (size_t)i >> 6;
+        uint64_t word = m_words[w] & (~(uint64_t)0 << (i & 63));
+        while (!word) {
+            if (++w == m_words.size()) return -1;
+            word = m_words[w];
+        }
+        return (int)(w * 64 + __builtin_ctzll(word));
+    }
+
+    // Visits the members in round-robin order from `start` (start, ...,
+    // size-1, 0, ..., start-1) until `f` returns true; returns that member,
+    // or -1 if it never did.
+    template <typename F>
+    int find_from(int start, F f) const
+    {
+        for (int i = find_next(start); i != -1; i = find_next(i + 1))
+            if (f(i)) return i;
+        for (int i = find_next(0); i != -1 && i < start; i = find_next(i + 1))
+            if (f(i)) return i;
+        return -1;
+    }
+
+    // find_from() for sets of at most 64 members, scanning one word held
+    // in a register.  The fixed-size router kernels know their sets fit.
+    template <typename F>
+    int find_from_word(int start, F f) const
+    {
+        uint64_t high = m_words[0] & (~(uint64_t)0 << start);
+        uint64_t low = m_words[0] & ~high;
+        for (; high; high &= high - 1) {
+            int i = __builtin_ctzll(high);
+            if (f(i)) return i;
+        }
+        for (; low; low &= low - 1) {
+            int i = __builtin_ctzll(low);
+            if (f(i)) return i;
+        }
+        return -1;
+    }
+
+private:
+    static uint64_t bit(int i) { return (uint64_t)1 << (i & 63); }
+
+    int m_size = 0;
+    std::vector<uint64_t, ArenaAllocator<uint64_t>> m_words;
+};
+
+} // namespace garnet
+
+#endif // __GARNET_BIT_MASK_HH__
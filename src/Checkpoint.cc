@@ -0,0 +1,148 @@
+#include "Checkpoint.hh"
+
+#include <algorithm>
+
+#include "GarnetSimObject.hh"
+#include "flit.hh"
+
+namespace garnet {
+
+namespace {
+
+const char kMagic[8] = {'G', 'A', 'R', 'N', 'E', 'T', 'C', 'K'};
+// Bump whenever any component changes what it saves.
+const uint32_t kVersion = 6;
+
+enum FlitTag : uint8_t { NO_FLIT = 0, FLIT = 1 };
+
+} // namespace
+
+CheckpointOut::CheckpointOut(const std::string& path, uint64_t cycle,
+                             const std::string& config)
+    : m_out(path, std::ios::binary | std::ios::trunc)
+{
+    m_out.write(kMagic, sizeof(kMagic));
+    put(kVersion);
+    put(cycle);
+    put(config);
+}
+
+void CheckpointOut::put(const std::string& text)
+{
+    put((uint64_t)text.size());
+    m_out.write(text.data(), text.size());
+}
+
+void CheckpointOut::putFlit(const flit* t_flit)
+{
+    if (!t_flit) {
+        put((uint8_t)NO_FLIT);
+        return;
+    }
+    put((uint8_t)FLIT);
+    t_flit->saveState(*this);
+}
+
+void CheckpointOut::setObjects(const std::vector<GarnetSimObject*>& objects)
+{
+    m_object_index.clear();
+    for (size_t i = 0; i < objects.size(); ++i)
+        m_object_index[objects[i]] = (uint32_t)i;
+    put((uint64_t)objects.size());
+}
+
+void CheckpointOut::putObject(const GarnetSimObject* obj)
+{
+    auto it = m_object_index.find(obj);
+    put(it != m_object_index.end() ? it->second : (uint32_t)-1);
+}
+
+CheckpointIn::CheckpointIn(const std::string& path)
+    : m_in(path, std::ios::binary)
+{
+    if (!m_in) {
+        m_error = "cannot open " + path;
+        return;
+    }
+    char magic[sizeof(kMagic)] = {};
+    m_in.read(magic, sizeof(magic));
+    if (!m_in || !std::equal(magic, magic + sizeof(magic), kMagic)) {
+        m_error = path + " is not a checkpoint";
+        return;
+    }
+    uint32_t version = 0;
+    get(version);
+    if (version != kVersion) {
+        m_error = path + " has checkpoint version " +
+                  std::to_string(version) + ", expected " +
+                  std::to_string(kVersion);
+        return;
+    }
+    get(m_cycle);
+    get(m_config);
+}
+
+std::string CheckpointIn::error() const
+{
+    if (!m_error.empty()) return m_error;
+    return m_in ? "" : "checkpoint is truncated";
+}
+
+void CheckpointIn::get(std::string& text)
+{
+    uint64_t size = 0;
+    get(size);
+    text.clear();
+    // Read in chunks so a corrupt size cannot allocate unbounded memory.
+    char buf[4096];
+    while (size > 0 && m_in) {
+        size_t n = size < sizeof(buf) ? (size_t)size : sizeof(buf);
+        m_in.read(buf, n);
+        text.append(buf, (size_t)m_in.gcount());
+        size -= n;
+    }
+}
+
+flit* CheckpointIn::getFlit()
+{
+    uint8_t tag = NO_FLIT;
+    get(tag);
+    if (tag == NO_FLIT) return nullptr;
+    if (tag != FLIT) {
+        fail("corrupt flit");
+        return nullptr;
+    }
+    flit* t_flit = new flit();
+    t_flit->loadState(*this);
+    return t_flit;
+}
+
+void CheckpointIn::setObjects(const std::vector<GarnetSimObject*>& objects)
+{
+    m_objects = objects;
+    uint64_t count = 0;
+    get(count);
+    if (count != objects.size())
+        fail("checkpoint has " + std::to_string(count) +
+             " simulated objects, the network " +
+             std::to_string(objects.size()));
+}
+
+GarnetSimObject* CheckpointIn::getObject()
+{
+    uint32_t index = 0;
+    get(index);
+    if (index >= m_objects.size()) {
+        fail("event for an unknown object");
+        return nullptr;
+    }
+    return m_objects[index];
+}
+
+void CheckpointIn::fail(const std::string& reason)
+{
+    // Running out of data is the more useful diagnosis.
+    if (m_error.empty()) m_error = m_in ? reason : "checkpoint is truncated";
+}
+
+} // namespace garnet
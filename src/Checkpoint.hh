@@ -0,0 +1,118 @@
+// Binary checkpoints of a running simulation (--checkpoint-every and
+// --restore in main.cc).
+//
+// A checkpoint holds dynamic state only and is restored into a network
+// built from the same command line.  Every component writes its fields
+// with saveState() and reads them back in the same order with loadState().
+// Flits are stored by value and reallocated on restore; event queue
+// entries refer to simulated objects by their index in
+// Topology::getSimObjects().  Values are stored in host byte order, so a
+// checkpoint only moves between builds for the same platform.
+
+#ifndef __GARNET_CHECKPOINT_HH__
+#define __GARNET_CHECKPOINT_HH__
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace garnet {
+
+class flit;
+class GarnetSimObject;
+
+class CheckpointOut {
+public:
+    // Creates `path` and writes the header; `config` describes the network
+    // the state belongs to and has to match on restore.
+    CheckpointOut(const std::string& path, uint64_t cycle,
+                  const std::string& config);
+
+    // False once a write failed.
+    bool ok() const { return (bool)m_out; }
+
+    template <typename T>
+    void put(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "only raw values are stored as bytes");
+        m_out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template <typename T>
+    void put(const std::vector<T>& values)
+    {
+        put((uint64_t)values.size());
+        for (const auto& value : values) put(value);
+    }
+    void put(const std::string& text);
+
+    // A flit or credit, or null.
+    void putFlit(const flit* t_flit);
+
+    // Objects putObject() can refer to, in the order used for restoring.
+    void setObjects(const std::vector<GarnetSimObject*>& objects);
+    void putObject(const GarnetSimObject* obj);
+
+private:
+    std::ofstream m_out;
+    std::unordered_map<const GarnetSimObject*, uint32_t> m_object_index;
+};
+
+class CheckpointIn {
+public:
+    // Opens `path` and reads the header; see ok() and error().
+    explicit CheckpointIn(const std::string& path);
+
+    // False if the file could not be read, is not a checkpoint of this
+    // version or ended early.
+    bool ok() const { return m_error.empty() && (bool)m_in; }
+    std::string error() const;
+
+    uint64_t cycle() const { return m_cycle; }
+    const std::string& config() const { return m_config; }
+
+    // Values are zero once the file has run out.
+    template <typename T>
+    void get(T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "only raw values are stored as bytes");
+        value = T();
+        m_in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+    template <typename T>
+    void get(std::vector<T>& values)
+    {
+        uint64_t size = 0;
+        get(size);
+        values.clear();
+        for (uint64_t i = 0; i < size && m_in; ++i) {
+            values.emplace_back();
+            get(values.back());
+        }
+    }
+    void get(std::string& text);
+
+    // Allocates the stored flit or credit; null if none was stored.
+    flit* getFlit();
+
+    void setObjects(const std::vector<GarnetSimObject*>& objects);
+    GarnetSimObject* getObject();
+
+    // Marks the checkpoint unusable, e.g. when it does not fit the network.
+    void fail(const std::string& reason);
+
+private:
+    std::ifstream m_in;
+    std::string m_error;
+    uint64_t m_cycle = 0;
+    std::string m_config;
+    std::vector<GarnetSimObject*> m_objects;
+};
+
+} // namespace garnet
+
+#endif // __GARNET_CHECKPOINT_HH__
@@ -0,0 +1,63 @@
+#include "CommonTypes.hh"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace garnet
+{
+
+namespace {
+
+// Sweep jobs build their networks concurrently.  Names are never removed,
+// and a deque never moves its elements, so a returned name stays valid.
+struct PortDirectionTable {
+    std::mutex lock;
+    std::deque<std::string> names;
+    std::unordered_map<std::string, PortDirection> ids;
+
+    PortDirectionTable()
+    {
+        for (const char* name : {"Local", "North", "East", "South", "West",
+                                 "Up", "Down"})
+            intern(name);
+    }
+
+    PortDirection intern(const std::string& name)
+    {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        PortDirection dirn = (PortDirection)names.size();
+        names.push_back(name);
+        ids.emplace(name, dirn);
+        return dirn;
+    }
+};
+
+PortDirectionTable& table()
+{
+    static PortDirectionTable* t = new PortDirectionTable;
+    return *t;
+}
+
+} // namespace
+
+PortDirection
+internPortDirection(const std::string& name)
+{
+    PortDirectionTable& t = table();
+    std::lock_guard<std::mutex> guard(t.lock);
+    return t.intern(name);
+}
+
+const std::string&
+portDirectionName(PortDirection dirn)
+{
+    static const std::string unknown = "Unknown";
+    PortDirectionTable& t = table();
+    std::lock_guard<std::mutex> guard(t.lock);
+    if (dirn < 0 || dirn >= (PortDirection)t.names.size()) return unknown;
+    return t.names[dirn];
+}
+
+} // namespace garnet
@@ -31,55 +31,145 @@
 #ifndef __GARNET_COMMON_TYPES_HH__
 #define __GARNET_COMMON_TYPES_HH__
 
-#include <string>
-#include <vector>
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <vector>
 
 namespace garnet
 {
 
-// Forward declaration
-class NetDest;
-
-// NetDest definition using vector for maximum portability
+// NIs whose sets fit inside a NetDest (make NETDEST_NIS=<n>).
+#ifndef GARNET_NETDEST_NIS
+#define GARNET_NETDEST_NIS 256
+#endif
+
+// Set of destination NI IDs, one bit per NI.  Routing tables hold one
+// per output link and every head flit is matched against them, so the
+// set operations work a 64-bit word at a time; the loops are simple
+// enough for the compiler to vectorize.  The words for the first
+// GARNET_NETDEST_NIS NIs live inside the set itself; only a set holding
+// a higher ID moves its words to the heap.
 class NetDest
 {
   public:
     NetDest() {}
-    
+
     void add(int dest_id) {
-        if (std::find(m_destinations.begin(), m_destinations.end(), dest_id) == m_destinations.end()) {
-            m_destinations.push_back(dest_id);
-        }
+        size_t word = (size_t)dest_id / kWordBits;
+        if (word >= m_size) resize(word + 1);
+        words()[word] |= bit(dest_id);
+    }
+
+    void remove(int dest_id) {
+        size_t word = (size_t)dest_id / kWordBits;
+        if (word < m_size) words()[word] &= ~bit(dest_id);
+    }
+
+    bool isElement(int dest_id) const {
+        size_t word = (size_t)dest_id / kWordBits;
+        return word < m_size && (words()[word] & bit(dest_id));
     }
-    
+
     bool intersectionIsNotEmpty(const NetDest& other) const {
-        for (int id : m_destinations) {
-            for (int other_id : other.m_destinations) {
-                if (id == other_id) return true;
-            }
+        size_t n = std::min(m_size, other.m_size);
+        const uint64_t* a = words();
+        const uint64_t* b = other.words();
+        uint64_t common = 0;
+        for (size_t i = 0; i < n; ++i)
+            common |= a[i] & b[i];
+        return common != 0;
+    }
+
+    bool isEmpty() const {
+        const uint64_t* w = words();
+        for (size_t i = 0; i < m_size; ++i)
+            if (w[i]) return false;
+        return true;
+    }
+
+    int count() const {
+        const uint64_t* w = words();
+        int n = 0;
+        for (size_t i = 0; i < m_size; ++i) n += __builtin_popcountll(w[i]);
+        return n;
+    }
+
+    void clear() {
+        m_size = 0;
+        m_heap.clear();
+    }
+
+    // Calls f(dest_id) for every member in increasing order.
+    template <typename F>
+    void forEach(F f) const {
+        const uint64_t* w = words();
+        for (size_t i = 0; i < m_size; ++i) {
+            for (uint64_t word = w[i]; word; word &= word - 1)
+                f((int)(i * kWordBits + __builtin_ctzll(word)));
         }
-        return false;
     }
-    
-    void clear() { m_destinations.clear(); }
+
+    std::vector<int> getDestinations() const {
+        std::vector<int> ids;
+        forEach([&ids](int id) { ids.push_back(id); });
+        return ids;
+    }
 
     void print() const {
         std::cout << "{";
-        for (int id : m_destinations) std::cout << id << " ";
+        forEach([](int id) { std::cout << id << " "; });
         std::cout << "}";
     }
 
   private:
-    std::vector<int> m_destinations;
+    static const size_t kWordBits = 64;
+    static const size_t kInlineWords =
+        (GARNET_NETDEST_NIS + kWordBits - 1) / kWordBits;
+
+    static uint64_t bit(int dest_id) {
+        return (uint64_t)1 << ((size_t)dest_id % kWordBits);
+    }
+
+    // The words in use are in m_heap once it is not empty, else inline.
+    uint64_t* words() { return m_heap.empty() ? m_inline : m_heap.data(); }
+    const uint64_t* words() const {
+        return m_heap.empty() ? m_inline : m_heap.data();
+    }
+
+    void resize(size_t size) {
+        if (size > kInlineWords) {
+            if (m_heap.empty()) m_heap.assign(m_inline, m_inline + m_size);
+            m_heap.resize(size, 0);
+        } else {
+            std::fill(m_inline + m_size, m_inline + size, 0);
+        }
+        m_size = size;
+    }
+
+    size_t m_size = 0;
+    uint64_t m_inline[kInlineWords] = {};
+    std::vector<uint64_t> m_heap;
 };
 
 // All common enums and typedefs go here
 
 typedef int SwitchID;
 typedef int NodeID;
-typedef std::string PortDirection;
+
+// Router port directions are interned into small integer IDs while the
+// topology is built; names are only needed for printing and for parsing
+// topology files.  The directions used by the built-in topologies have
+// fixed IDs.
+typedef int PortDirection;
+enum BuiltinPortDirection {LOCAL_DIRN_, NORTH_DIRN_, EAST_DIRN_,
+                           SOUTH_DIRN_, WEST_DIRN_, UP_DIRN_, DOWN_DIRN_,
+                           NUM_BUILTIN_DIRN_};
+
+// ID of `name`, allocating one on first use.  Thread-safe.
+PortDirection internPortDirection(const std::string& name);
+const std::string& portDirectionName(PortDirection dirn);
 
 enum flit_type {HEAD_, BODY_, TAIL_, HEAD_TAIL_,
                 CREDIT_, NUM_FLIT_TYPE_};
@@ -93,11 +183,11 @@ enum RoutingAlgorithm { TABLE_ = 0, XY_ = 1, CUSTOM_ = 2,
 struct RouteInfo
 {
     RouteInfo()
-        : vnet(0), src_ni(0), src_router(0), dest_ni(0), dest_router(0),
-          hops_traversed(0)
+        : vnet(0), src_ni(0), src_router(0), dest_ni(0), dest_router(0)
     {}
 
-    // destination format for table-based routing
+    // destination format for table-based routing; left empty for unicast
+    // packets, whose destination is dest_ni
     int vnet;
     NetDest net_dest;
 
@@ -106,7 +196,6 @@ struct RouteInfo
     int src_router;
     int dest_ni;
     int dest_router;
-    int hops_traversed;
 };
 
 } // namespace garnet
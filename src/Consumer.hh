@@ -13,6 +13,26 @@ class Consumer : public GarnetSimObject
     virtual ~Consumer() = default;
 
     virtual void scheduleEvent(uint64_t time) = 0;
+
+    // Flits/credits sitting in links that deliver to this consumer,
+    // whether or not they have arrived yet.
+    void inbound_enqueued() { m_inbound_flits++; }
+    void inbound_dequeued() { m_inbound_flits--; }
+    bool has_inbound() const { return m_inbound_flits != 0; }
+
+    void saveState(CheckpointOut& cp) const override
+    {
+        GarnetSimObject::saveState(cp);
+        cp.put(m_inbound_flits);
+    }
+    void loadState(CheckpointIn& cp) override
+    {
+        GarnetSimObject::loadState(cp);
+        cp.get(m_inbound_flits);
+    }
+
+  private:
+    uint64_t m_inbound_flits = 0;
 };
 
 } // namespace garnet
@@ -0,0 +1,90 @@
+// Counter-based random numbers: Philox4x32-10 (Salmon et al., "Parallel
+// random numbers: as easy as 1, 2, 3", SC 2011).
+//
+// Word n of a stream is a pure function of the stream's key (seed, node,
+// stream) and n: ten rounds of multiply/xor over the 128-bit counter
+// (n / 4, stream) under the 64-bit key (seed, node), of which it is lane
+// n % 4.  Streams with different keys are independent whatever the seeds
+// are, a draw does not depend on what any other node or stream drew
+// before it, and the whole state is the key, the position and the current
+// block: 32 bytes, stored as raw bytes in a checkpoint.
+//
+// Meets the UniformRandomBitGenerator requirements, so the <random>
+// distributions take it like std::mt19937.
+
+#ifndef __GARNET_COUNTER_RNG_HH__
+#define __GARNET_COUNTER_RNG_HH__
+
+#include <cstdint>
+
+namespace garnet {
+
+class CounterRng {
+public:
+    typedef uint32_t result_type;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xffffffffu; }
+
+    CounterRng() { seed(0, 0, 0); }
+    CounterRng(uint32_t seed_value, uint32_t node, uint32_t stream)
+    {
+        seed(seed_value, node, stream);
+    }
+
+    // Starts over at word 0 of the stream keyed by the arguments.
+    void
+    seed(uint32_t seed_value, uint32_t node, uint32_t stream)
+    {
+        m_key[0] = seed_value;
+        m_key[1] = node;
+        m_stream = stream;
+        m_position = 0;
+    }
+
+    result_type
+    operator()()
+    {
+        uint32_t lane = (uint32_t)(m_position & 3);
+        if (lane == 0) block(m_position >> 2, m_block);
+        ++m_position;
+        return m_block[lane];
+    }
+
+    // Words drawn so far.
+    uint64_t position() const { return m_position; }
+
+    // Block `counter` of this stream's key: words 4 * counter onwards.
+    void
+    block(uint64_t counter, uint32_t out[4]) const
+    {
+        uint32_t c0 = (uint32_t)counter, c1 = (uint32_t)(counter >> 32);
+        uint32_t c2 = m_stream, c3 = 0;
+        uint32_t k0 = m_key[0], k1 = m_key[1];
+        for (int round = 0; round < 10; ++round) {
+            if (round > 0) {
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+            uint64_t p0 = (uint64_t)0xD2511F53u * c0;
+            uint64_t p1 = (uint64_t)0xCD9E8D57u * c2;
+            c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+            c1 = (uint32_t)p1;
+            c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+            c3 = (uint32_t)p0;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+    uint32_t m_key[2];
+    uint32_t m_stream;
+    uint64_t m_position;
+    uint32_t m_block[4];    // block of the last word drawn
+};
+
+} // namespace garnet
+
+#endif // __GARNET_COUNTER_RNG_HH__
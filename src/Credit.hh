@@ -31,38 +31,15 @@
 #ifndef __GARNET_CREDIT_HH__
 #define __GARNET_CREDIT_HH__
 
-#include <cassert>
-#include <iostream>
-#include <cstdint>
-
-#include "CommonTypes.hh"
 #include "flit.hh"
 
 namespace garnet
 {
 
-// Credit Signal for buffers inside VC
-// Carries m_vc (inherits from flit.hh)
-// and m_is_free_signal (whether VC is free or not)
-
-class Credit : public flit
-{
-  public:
-    Credit() {};
-    Credit(int vc, bool is_free_signal, uint64_t curTime);
-
-    flit* serialize(int ser_id, int parts, uint32_t bWidth);
-    flit* deserialize(int des_id, int num_flits, uint32_t bWidth);
-
-    void print(std::ostream& out) const;
-
-    ~Credit() {};
-
-    bool is_free_signal() { return m_is_free_signal; }
-
-  private:
-    bool m_is_free_signal;
-};
+// Credit Signal for buffers inside VC: a flit of type CREDIT_ that
+// carries the VC and whether it is free again (see flit's credit
+// constructor and is_free_signal()).
+typedef flit Credit;
 
 } // namespace garnet
 
@@ -33,6 +33,7 @@
 
 #include "OutputUnit.hh"
 #include "Router.hh"
+#include "RouterKernel.hh"
 #include "GarnetNetwork.hh"
 #include "flitBuffer.hh"
 #include "NetDest.hh" // Added to resolve incomplete type warning
@@ -40,16 +41,34 @@
 namespace garnet
 {
 
+struct CrossbarSwitch::Kernels
+{
+    typedef void (CrossbarSwitch::*Kernel)();
+
+    // The crossbar only depends on the radix.
+    template <int Ports, int VcsPerVnet>
+    static Kernel
+    get()
+    {
+        return &CrossbarSwitch::traverse<Ports>;
+    }
+};
+
 CrossbarSwitch::CrossbarSwitch(Router *router)
-  : m_router(router), m_num_vcs(m_router->get_num_vcs()),
-    switchBuffers(0)
+  : m_router(router), m_kernel(&CrossbarSwitch::traverse<0>),
+    m_num_vcs(m_router->get_num_vcs()),
+    m_num_inports(m_router->get_num_inports())
 {
+    switchBuffers =
+        m_router->getArena().create_array<flitBuffer>(m_num_inports);
 }
 
 // --- ADD THIS ENTIRE FUNCTION ---
 CrossbarSwitch::~CrossbarSwitch()
 {
-    for (auto& buf : switchBuffers) {
+    // The arena destroys the buffers after this switch.
+    for (int inport = 0; inport < m_num_inports; inport++) {
+        flitBuffer& buf = switchBuffers[inport];
         while (!buf.isEmpty()) {
             flit* fl = buf.getTopFlit();
             delete fl;
@@ -61,7 +80,7 @@ CrossbarSwitch::~CrossbarSwitch()
 void
 CrossbarSwitch::init()
 {
-    switchBuffers.resize(m_router->get_num_inports());
+    m_kernel = selectRouterKernel<Kernels>(m_router->get_shape());
 }
 
 /*
@@ -73,8 +92,18 @@ CrossbarSwitch::init()
 void
 CrossbarSwitch::wakeup()
 {
+    if (m_num_buffered == 0) return;
+    (this->*m_kernel)();
+}
+
+template <int Ports>
+void
+CrossbarSwitch::traverse()
+{
+    const int num_inports = Ports ? Ports : m_num_inports;
     uint64_t current_time = m_router->get_net_ptr()->getEventQueue()->get_current_time();
-    for (auto& switch_buffer : switchBuffers) {
+    for (int inport = 0; inport < num_inports; inport++) {
+        flitBuffer &switch_buffer = switchBuffers[inport];
         if (!switch_buffer.isReady(current_time)) {
             continue;
         }
@@ -91,8 +120,28 @@ CrossbarSwitch::wakeup()
             // in the next cycle
             m_router->getOutputUnit(outport)->insert_flit(t_flit);
             switch_buffer.getTopFlit();
+            m_num_buffered--;
         }
     }
 }
 
+void
+CrossbarSwitch::saveState(CheckpointOut& cp) const
+{
+    GarnetSimObject::saveState(cp);
+    for (int inport = 0; inport < m_num_inports; inport++)
+        switchBuffers[inport].saveState(cp);
+}
+
+void
+CrossbarSwitch::loadState(CheckpointIn& cp)
+{
+    GarnetSimObject::loadState(cp);
+    m_num_buffered = 0;
+    for (int inport = 0; inport < m_num_inports; inport++) {
+        switchBuffers[inport].loadState(cp);
+        m_num_buffered += switchBuffers[inport].getSize();
+    }
+}
+
 } // namespace garnet
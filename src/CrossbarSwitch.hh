@@ -47,22 +47,35 @@ class Router;
 class CrossbarSwitch : public GarnetSimObject
 {
   public:
+    // Built once the router has all its inports.
     CrossbarSwitch(Router *router);
     ~CrossbarSwitch();
-    void wakeup();
+    void wakeup() final;
     void init();
     void print(std::ostream& out) const {};
 
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp) override;
+
     inline void
     update_sw_winner(int inport, flit *t_flit)
     {
         switchBuffers[inport].insert(t_flit);
+        m_num_buffered++;
     }
 
   private:
+    // Switch traversal, instantiated per router radix (see
+    // RouterKernel.hh); <0> works for any router.
+    template <int Ports> void traverse();
+    struct Kernels;
+
     Router *m_router;
+    void (CrossbarSwitch::*m_kernel)();
     int m_num_vcs;
-    std::vector<flitBuffer> switchBuffers;
+    int m_num_inports;
+    flitBuffer *switchBuffers;   // one per inport, in the router's arena
+    int m_num_buffered = 0;   // flits in switchBuffers
 };
 
 } // namespace garnet
@@ -1,40 +1,232 @@
 #include "EventQueue.hh"
 
+#include <algorithm>
+#include <utility>
+
 namespace garnet {
 
-EventQueue::~EventQueue() {
-    while (!m_event_queue.empty()) {
-        delete m_event_queue.top();
-        m_event_queue.pop();
+EventQueue::EventQueue(uint32_t wheel_slots)
+{
+    // Round up to a power of two so the slot index is a mask.
+    uint64_t n = 1;
+    while (n < wheel_slots) n <<= 1;
+    m_slots.resize(n);
+    m_slot_mask = n - 1;
+}
+
+void
+EventQueue::reserve(size_t events) {
+    for (auto& slot : m_slots) slot.events.reserve(events);
+}
+
+void
+EventQueue::schedule_at(GarnetSimObject* obj, uint64_t when) {
+    m_wakeup_requests++;
+    if (obj->get_pending_wakeup() == when) {
+        return;
     }
+    obj->set_pending_wakeup(when);
+    insert(Event(obj, when));
 }
 
 void
-EventQueue::schedule(GarnetSimObject* obj, uint64_t time) {
-    Event* event = new Event(obj, m_current_time + time);
-    m_event_queue.push(event);
+EventQueue::insert(const Event& event) {
+    uint64_t when = event.get_time();
+    if (when >= m_base && when - m_base < m_slots.size()) {
+        Slot& slot = slot_for(when);
+        slot.events.push_back(event);
+        slot.sorted = false;
+        m_wheel_count++;
+    } else {
+        m_overflow.push_back(event);
+        std::push_heap(m_overflow.begin(), m_overflow.end(), EventCompare());
+    }
+}
+
+// Move overflow events that now fall inside the wheel window onto the
+// wheel.
+void
+EventQueue::pull_overflow() {
+    while (!m_overflow.empty()) {
+        const Event& top = m_overflow.front();
+        if (top.get_time() < m_base ||
+            top.get_time() - m_base >= m_slots.size())
+            break;
+        Slot& slot = slot_for(top.get_time());
+        slot.events.push_back(top);
+        slot.sorted = false;
+        m_wheel_count++;
+        std::pop_heap(m_overflow.begin(), m_overflow.end(), EventCompare());
+        m_overflow.pop_back();
+    }
 }
 
-Event*
+void
+EventQueue::advance_base(uint64_t new_base) {
+    m_base = new_base;
+    pull_overflow();
+}
+
+// Puts the undispatched part of a slot in rank order and drops requests
+// the pending-wakeup marker could not catch (an object scheduled for this
+// cycle again after a request for a different cycle).
+void
+EventQueue::sort_slot(Slot& slot) {
+    auto first = slot.events.begin() + slot.head;
+    std::sort(first, slot.events.end(),
+              [](const Event& a, const Event& b) {
+                  return a.get_rank() < b.get_rank();
+              });
+    auto last = std::unique(first, slot.events.end(),
+                            [](const Event& a, const Event& b) {
+                                return a.get_obj() == b.get_obj();
+                            });
+    m_wheel_count -= slot.events.end() - last;
+    slot.events.erase(last, slot.events.end());
+    slot.sorted = true;
+}
+
+Event
 EventQueue::get_next_event() {
-    if (m_event_queue.empty()) {
-        return nullptr;
+    if (is_empty()) {
+        return Event();
+    }
+
+    // Nothing close by: jump the wheel straight to the next far event.
+    if (m_wheel_count == 0 && m_overflow.front().get_time() >= m_base) {
+        advance_base(m_overflow.front().get_time());
+    }
+
+    if (m_wheel_count > 0) {
+        while (slot_for(m_base).empty()) {
+            advance_base(m_base + 1);
+        }
     }
 
-    Event* event = m_event_queue.top();
-    m_event_queue.pop();
-    m_current_time = event->get_time();
+    Event event;
+    if (!m_overflow.empty() &&
+        (m_wheel_count == 0 || m_overflow.front().get_time() < m_base)) {
+        event = m_overflow.front();
+        std::pop_heap(m_overflow.begin(), m_overflow.end(), EventCompare());
+        m_overflow.pop_back();
+    } else {
+        Slot& slot = slot_for(m_base);
+        if (!slot.sorted) sort_slot(slot);
+        event = slot.events[slot.head++];
+        if (slot.empty()) {
+            slot.events.clear();
+            slot.head = 0;
+        }
+        m_wheel_count--;
+    }
+
+    m_current_time = event.get_time();
+    m_dispatched++;
+    // Once dispatched, a new request for this cycle is a real re-wakeup.
+    if (event.get_obj()->get_pending_wakeup() == m_current_time) {
+        event.get_obj()->set_pending_wakeup((uint64_t)-1);
+    }
     return event;
 }
 
-bool
-EventQueue::is_empty() const {
-    return m_event_queue.empty();
+uint64_t
+EventQueue::peek_next_time() const {
+    uint64_t next = (uint64_t)-1;
+    if (!m_overflow.empty()) {
+        next = m_overflow.front().get_time();
+    }
+    if (m_wheel_count > 0) {
+        uint64_t t = m_base;
+        while (m_slots[t & m_slot_mask].empty()) t++;
+        next = std::min(next, t);
+    }
+    return next;
+}
+
+std::vector<Event>
+EventQueue::take_all() {
+    std::vector<Event> events;
+    for (auto& slot : m_slots) {
+        events.insert(events.end(), slot.events.begin() + slot.head,
+                      slot.events.end());
+        slot.events.clear();
+        slot.head = 0;
+        slot.sorted = true;
+    }
+    events.insert(events.end(), m_overflow.begin(), m_overflow.end());
+    m_overflow.clear();
+    m_wheel_count = 0;
+    return events;
+}
+
+void
+EventQueue::put_back(const std::vector<Event>& events) {
+    for (const auto& event : events) insert(event);
+}
+
+uint64_t
+EventQueue::get_scheduled_wakeups() const {
+    // Pending requests may still hold duplicates that sort_slot() has not
+    // removed yet; count each (object, cycle) once.
+    std::vector<std::pair<GarnetSimObject*, uint64_t>> pending;
+    for (const auto& slot : m_slots)
+        for (size_t i = slot.head; i < slot.events.size(); ++i)
+            pending.emplace_back(slot.events[i].get_obj(),
+                                 slot.events[i].get_time());
+    for (const auto& event : m_overflow)
+        pending.emplace_back(event.get_obj(), event.get_time());
+    std::sort(pending.begin(), pending.end());
+    uint64_t distinct =
+        std::unique(pending.begin(), pending.end()) - pending.begin();
+    return m_dispatched + distinct;
 }
 
 uint64_t
-EventQueue::get_current_time() const {
-    return m_current_time;
+EventQueue::get_coalesced_wakeups() const {
+    return m_wakeup_requests - get_scheduled_wakeups();
+}
+
+void
+EventQueue::add_wakeup_counts(const EventQueue& other) {
+    m_wakeup_requests += other.m_wakeup_requests;
+    m_dispatched += other.m_dispatched;
+}
+
+void
+EventQueue::saveState(CheckpointOut& cp) const {
+    std::vector<Event> pending;
+    for (const auto& slot : m_slots)
+        pending.insert(pending.end(), slot.events.begin() + slot.head,
+                       slot.events.end());
+    pending.insert(pending.end(), m_overflow.begin(), m_overflow.end());
+    std::sort(pending.begin(), pending.end(),
+              [](const Event& a, const Event& b) { return EventCompare()(b, a); });
+
+    cp.put(m_current_time);
+    cp.put(m_wakeup_requests);
+    cp.put(m_dispatched);
+    cp.put((uint64_t)pending.size());
+    for (const auto& event : pending) {
+        cp.putObject(event.get_obj());
+        cp.put(event.get_time());
+    }
+}
+
+void
+EventQueue::loadState(CheckpointIn& cp) {
+    take_all();
+    uint64_t now = 0, count = 0;
+    cp.get(now);
+    cp.get(m_wakeup_requests);
+    cp.get(m_dispatched);
+    set_current_time(now);
+    cp.get(count);
+    for (uint64_t i = 0; i < count && cp.ok(); ++i) {
+        GarnetSimObject* obj = cp.getObject();
+        uint64_t time = 0;
+        cp.get(time);
+        if (obj) insert(Event(obj, time));
+    }
 }
 
-} // namespace garnet
\ No newline at end of file
+} // namespace garnet
@@ -1,50 +1,121 @@
 #ifndef __GARNET_EVENT_QUEUE_HH__
 #define __GARNET_EVENT_QUEUE_HH__
 
+#include <cstddef>
 #include <cstdint>
-#include <queue>
 #include <vector>
 
 #include "GarnetSimObject.hh"
 
 namespace garnet {
 
+// Events are stored by value.  m_rank is the object's construction rank and
+// orders events of the same cycle, so dispatch order never depends on which
+// component happened to schedule first.  That keeps a partition of the
+// network dispatching its events in the same order as the whole network
+// would.
 class Event {
 public:
+    Event() : m_obj(nullptr), m_time(0), m_rank(0) {}
     Event(GarnetSimObject* obj, uint64_t time) :
-        m_obj(obj), m_time(time) {}
+        m_obj(obj), m_time(time), m_rank(obj->get_rank()) {}
 
     GarnetSimObject* get_obj() const { return m_obj; }
     uint64_t get_time() const { return m_time; }
+    uint64_t get_rank() const { return m_rank; }
 
 private:
     GarnetSimObject* m_obj;
     uint64_t m_time;
+    uint64_t m_rank;
 };
 
 struct EventCompare {
-    bool operator()(const Event* a, const Event* b) const {
-        return a->get_time() > b->get_time();
+    bool operator()(const Event& a, const Event& b) const {
+        if (a.get_time() != b.get_time())
+            return a.get_time() > b.get_time();
+        return a.get_rank() > b.get_rank();
     }
 };
 
+// Calendar (timing-wheel) event queue.
+//
+// Events less than m_num_slots cycles ahead of the wheel base land in the
+// slot (time % m_num_slots); every slot only ever holds events of a single
+// cycle.  A slot is sorted by rank when its cycle is dispatched.  Anything
+// further out goes to an overflow heap and is moved onto the wheel once the
+// base gets close enough.  Slots keep their capacity, so steady-state
+// schedule/pop do not allocate; reserve() sizes them up front.
+//
+// A request for a cycle in which the object already has a wakeup pending
+// is dropped, so each object runs at most once per cycle from the queue.
 class EventQueue {
 public:
-    EventQueue() = default;
-    ~EventQueue();
-
-    void schedule(GarnetSimObject* obj, uint64_t time);
-    Event* get_next_event();
-    bool is_empty() const;
-    uint64_t get_current_time() const;
-    void set_current_time(uint64_t time) { m_current_time = time; }
-    uint64_t peek_next_time() const { 
-        if (m_event_queue.empty()) return (uint64_t)-1;
-        return m_event_queue.top()->get_time();
+    explicit EventQueue(uint32_t wheel_slots = 64);
+    ~EventQueue() = default;
+
+    void schedule(GarnetSimObject* obj, uint64_t time) {
+        schedule_at(obj, m_current_time + time);
+    }
+    // Same as schedule(), with an absolute cycle.
+    void schedule_at(GarnetSimObject* obj, uint64_t when);
+
+    // Pops the earliest event and advances the current time to it.
+    // Returns an Event with a null object when the queue is empty.
+    Event get_next_event();
+
+    bool is_empty() const { return m_wheel_count == 0 && m_overflow.empty(); }
+    uint64_t get_current_time() const { return m_current_time; }
+    void set_current_time(uint64_t time) {
+        m_current_time = time;
+        // An empty wheel can follow the clock so near events stay on it.
+        if (m_wheel_count == 0 && time > m_base) advance_base(time);
     }
+    uint64_t peek_next_time() const;
+    // Makes room in every slot for `events` same-cycle events.
+    void reserve(size_t events);
+
+    // Removes and returns every pending event, e.g. to hand them to
+    // another queue with put_back().
+    std::vector<Event> take_all();
+    void put_back(const std::vector<Event>& events);
+
+    // Distinct wakeups (dispatched or still pending) and the requests
+    // dropped as same-cycle duplicates of them.
+    uint64_t get_scheduled_wakeups() const;
+    uint64_t get_coalesced_wakeups() const;
+    // Folds in the counters of a queue that ran part of this network.
+    void add_wakeup_counts(const EventQueue& other);
+
+    // Clock, counters and pending events, which refer to their objects
+    // through the checkpoint's object list.  loadState() replaces any
+    // pending events.
+    void saveState(CheckpointOut& cp) const;
+    void loadState(CheckpointIn& cp);
 
 private:
-    std::priority_queue<Event*, std::vector<Event*>, EventCompare> m_event_queue;
+    struct Slot {
+        std::vector<Event> events;
+        size_t head = 0;
+        bool sorted = true;
+
+        bool empty() const { return head == events.size(); }
+    };
+
+    Slot& slot_for(uint64_t time) { return m_slots[time & m_slot_mask]; }
+    void insert(const Event& event);
+    void advance_base(uint64_t new_base);
+    void pull_overflow();
+    void sort_slot(Slot& slot);
+
+    std::vector<Slot> m_slots;
+    uint64_t m_slot_mask;
+    uint64_t m_base = 0;        // earliest cycle the wheel may hold
+    size_t m_wheel_count = 0;   // events currently on the wheel
+    uint64_t m_wakeup_requests = 0;
+    uint64_t m_dispatched = 0;
+
+    std::vector<Event> m_overflow;  // min-heap on (time, rank)
     uint64_t m_current_time = 0;
 };
 
@@ -0,0 +1,232 @@
+#include "FlitPool.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace garnet {
+
+namespace {
+
+struct FreeSlot {
+    FreeSlot* next;
+};
+
+// Size class of a request, or -1 if it is too large for the pool.
+inline int size_class(size_t size)
+{
+    size_t lines = (size + FlitPool::kCacheLine - 1) / FlitPool::kCacheLine;
+    return lines <= (size_t)FlitPool::kSizeClasses ? (int)lines - 1 : -1;
+}
+
+inline size_t slot_size(int cls)
+{
+    return (cls + 1) * FlitPool::kCacheLine;
+}
+
+// A chain of free slots of one size class.
+struct Batch {
+    FreeSlot* head;
+    FreeSlot* tail;
+    size_t count;
+};
+
+// Slabs left behind by exited threads, and free slots that exited threads
+// or threads holding too many handed back.  Never destroyed: objects from
+// its slabs may still be freed during static destruction.
+struct Depot {
+    std::mutex lock;
+    std::vector<Batch> free[FlitPool::kSizeClasses];
+    std::vector<void*> slabs;
+};
+
+Depot& depot()
+{
+    static Depot* d = new Depot;
+    return *d;
+}
+
+#ifdef GARNET_POOL_DEBUG
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_frees{0};
+std::atomic<uint64_t> g_slabs{0};
+std::atomic<uint64_t> g_heap{0};
+
+struct LeakReport {
+    ~LeakReport()
+    {
+        FlitPool::Counters c = FlitPool::counters();
+        std::fprintf(stderr,
+                     "FlitPool: %llu allocations, %llu slabs, %llu live at "
+                     "exit\n",
+                     (unsigned long long)c.allocations,
+                     (unsigned long long)c.slabs,
+                     (unsigned long long)c.live());
+    }
+} g_leak_report;
+#endif
+
+struct ThreadCache {
+    FreeSlot* free[FlitPool::kSizeClasses] = {};
+    size_t count[FlitPool::kSizeClasses] = {};
+    size_t target[FlitPool::kSizeClasses] = {};   // see FlitPool::reserve
+    std::vector<void*> slabs;
+
+    ~ThreadCache()
+    {
+        Depot& d = depot();
+        std::lock_guard<std::mutex> guard(d.lock);
+        for (int cls = 0; cls < FlitPool::kSizeClasses; ++cls) {
+            if (!free[cls]) continue;
+            FreeSlot* tail = free[cls];
+            while (tail->next) tail = tail->next;
+            d.free[cls].push_back(Batch{free[cls], tail, count[cls]});
+        }
+        d.slabs.insert(d.slabs.end(), slabs.begin(), slabs.end());
+    }
+
+    void push(int cls, const Batch& batch)
+    {
+        batch.tail->next = free[cls];
+        free[cls] = batch.head;
+        count[cls] += batch.count;
+    }
+
+    // Adds a batch from the depot, or else a new slab, to the free list.
+    void refill(int cls)
+    {
+        {
+            Depot& d = depot();
+            std::lock_guard<std::mutex> guard(d.lock);
+            if (!d.free[cls].empty()) {
+                push(cls, d.free[cls].back());
+                d.free[cls].pop_back();
+                return;
+            }
+        }
+        size_t size = slot_size(cls);
+        void* slab = nullptr;
+        if (posix_memalign(&slab, FlitPool::kCacheLine,
+                           size * FlitPool::kSlabSlots) != 0)
+            throw std::bad_alloc();
+        slabs.push_back(slab);
+#ifdef GARNET_POOL_DEBUG
+        ++g_slabs;
+#endif
+        char* base = static_cast<char*>(slab);
+        Batch batch{nullptr, reinterpret_cast<FreeSlot*>(
+                        base + (FlitPool::kSlabSlots - 1) * size), 0};
+        for (size_t i = FlitPool::kSlabSlots; i-- > 0; ) {
+            FreeSlot* slot = reinterpret_cast<FreeSlot*>(base + i * size);
+            slot->next = batch.head;
+            batch.head = slot;
+        }
+        batch.count = FlitPool::kSlabSlots;
+        push(cls, batch);
+    }
+
+    // Hands a slab's worth of free slots to the depot.
+    void spill(int cls)
+    {
+        Batch batch{free[cls], free[cls], FlitPool::kSlabSlots};
+        for (size_t i = 1; i < batch.count; ++i) batch.tail = batch.tail->next;
+        free[cls] = batch.tail->next;
+        batch.tail->next = nullptr;
+        count[cls] -= batch.count;
+        Depot& d = depot();
+        std::lock_guard<std::mutex> guard(d.lock);
+        d.free[cls].push_back(batch);
+    }
+};
+
+thread_local ThreadCache t_cache;
+
+} // namespace
+
+void* FlitPool::allocate(size_t size)
+{
+    int cls = size_class(size);
+    if (cls < 0) return ::operator new(size);
+#ifdef GARNET_POOL_DEBUG
+    ++g_allocations;
+#endif
+    ThreadCache& cache = t_cache;
+    if (!cache.free[cls]) cache.refill(cls);
+    FreeSlot* slot = cache.free[cls];
+    cache.free[cls] = slot->next;
+    --cache.count[cls];
+    return slot;
+}
+
+void FlitPool::release(void* p, size_t size)
+{
+    if (!p) return;
+    int cls = size_class(size);
+    if (cls < 0) {
+        ::operator delete(p);
+        return;
+    }
+#ifdef GARNET_POOL_DEBUG
+    ++g_frees;
+#endif
+    ThreadCache& cache = t_cache;
+    FreeSlot* slot = static_cast<FreeSlot*>(p);
+    slot->next = cache.free[cls];
+    cache.free[cls] = slot;
+    if (++cache.count[cls] > cache.target[cls] + 2 * kSlabSlots)
+        cache.spill(cls);
+}
+
+void FlitPool::reserve(size_t size, size_t count)
+{
+    int cls = size_class(size);
+    if (cls < 0) return;
+    ThreadCache& cache = t_cache;
+    cache.target[cls] = std::max(cache.target[cls], count);
+    while (cache.count[cls] < cache.target[cls]) cache.refill(cls);
+}
+
+FlitPool::Counters FlitPool::counters()
+{
+    Counters c;
+#ifdef GARNET_POOL_DEBUG
+    c.allocations = g_allocations;
+    c.frees = g_frees;
+    c.slabs = g_slabs;
+    c.heap = g_heap;
+#endif
+    return c;
+}
+
+} // namespace garnet
+
+#ifdef GARNET_POOL_DEBUG
+// Counts every heap allocation; the pool's slabs come from posix_memalign
+// and so are not counted twice.
+void* operator new(size_t size)
+{
+    ++garnet::g_heap;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+#endif
@@ -0,0 +1,62 @@
+// Slab allocator behind flit (and credit) and PacketHeader operator
+// new/delete.
+//
+// A header and its flits are allocated and freed for every packet and a
+// credit for every hop, so they come from slabs of cache-line aligned
+// slots rather than the heap: one size class per slot size of one to four
+// cache lines.  Every thread keeps its own free list: the partitions of a
+// SimKernel and concurrent sweep jobs (each simulating its own network)
+// never contend, and an object freed on another thread than the one that
+// allocated it joins the freeing thread's list.  A shared depot balances
+// the lists: a thread holding more than two slabs' worth of free slots
+// beyond its reserve() hands one slab's worth to the depot, and a thread
+// that runs dry draws from the depot before allocating a new slab; an
+// exiting thread leaves its slabs and free slots there.  SimKernel
+// reserves each partition's share of the network's buffer capacity up
+// front, so once the source queues have reached their peak a run
+// allocates no new slabs, on any number of threads.
+//
+// Building with GARNET_POOL_DEBUG (make POOL_DEBUG=1) counts allocations,
+// frees and slabs, and reports objects never freed at exit.  It also
+// counts every heap allocation the process makes, pool or not, so a run
+// can check that its steady state allocates nothing per packet.
+
+#ifndef __GARNET_FLIT_POOL_HH__
+#define __GARNET_FLIT_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace garnet {
+
+class FlitPool {
+public:
+    static const size_t kCacheLine = 64;
+    // Slot sizes are 1..kSizeClasses cache lines.  Flits and credits take
+    // one; a PacketHeader two, or more with a larger NETDEST_NIS.
+    static const int    kSizeClasses = 4;
+    // Slots allocated at once when neither the thread nor the depot has
+    // any of the size left.
+    static const size_t kSlabSlots = 256;
+
+    // Larger requests fall back to the heap.
+    static void* allocate(size_t size);
+    static void  release(void* p, size_t size);
+    // Gives the calling thread at least `count` free slots for objects of
+    // `size` and keeps them there.
+    static void  reserve(size_t size, size_t count);
+
+    struct Counters {
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+        uint64_t slabs = 0;      // heap allocations made by the pool
+        uint64_t heap = 0;       // operator new calls, by anyone
+        uint64_t live() const { return allocations - frees; }
+    };
+    // All zero unless built with GARNET_POOL_DEBUG.
+    static Counters counters();
+};
+
+} // namespace garnet
+
+#endif // __GARNET_FLIT_POOL_HH__
@@ -64,6 +64,7 @@ GarnetNetwork::GarnetNetwork(const Params &p)
     m_routing_algorithm = p.routing_algorithm;
     m_next_packet_id = 0;
     m_debug = p.enable_debug;
+    m_generic_router_kernels = p.generic_router_kernels;
 
     m_enable_fault_model = p.enable_fault_model;
     if (m_enable_fault_model)
@@ -83,6 +84,16 @@ GarnetNetwork::~GarnetNetwork()
 void
 GarnetNetwork::init()
 {
+    // Only table routing looks every hop up; XY consults the uncompiled
+    // table just where a direction is missing, and is kept free of a
+    // routers x vnets x NIs array that grows with the square of the mesh.
+    m_routing_table_bytes = 0;
+    for (auto router : m_routers) {
+        router->buildCrossbar();
+        if (m_routing_algorithm == TABLE_)
+            m_routing_table_bytes += router->compileRoutingTable(m_nis.size());
+    }
+
     if (m_enable_fault_model) {
         for (std::vector<Router*>::const_iterator i = m_routers.begin();
              i != m_routers.end(); ++i) {
@@ -122,6 +133,24 @@ GarnetNetwork::print(std::ostream& out) const
     m_garnetStats.print(out);
 }
 
-void GarnetNetwork::update_traffic_distribution(RouteInfo route) {}
+void GarnetNetwork::update_traffic_distribution(const RouteInfo& route) {}
+
+void
+GarnetNetwork::saveState(CheckpointOut& cp) const
+{
+    m_event_queue.saveState(cp);
+    cp.put(m_garnetStats);
+    cp.put((int)m_next_packet_id);
+}
+
+void
+GarnetNetwork::loadState(CheckpointIn& cp)
+{
+    m_event_queue.loadState(cp);
+    cp.get(m_garnetStats);
+    int next_packet_id = 0;
+    cp.get(next_packet_id);
+    m_next_packet_id = next_packet_id;
+}
 
 } // namespace garnet
\ No newline at end of file
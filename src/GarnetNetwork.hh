@@ -32,6 +32,7 @@
 #ifndef __GARNET_NETWORK_HH__
 #define __GARNET_NETWORK_HH__
 
+#include <atomic>
 #include <iostream>
 #include <vector>
 
@@ -63,6 +64,7 @@ struct GarnetNetworkParams {
     int routing_algorithm;
     bool enable_fault_model;
     bool enable_debug;
+    bool generic_router_kernels;    // never use RouterKernel.hh shapes
     // Add other parameters as needed
 };
 
@@ -74,9 +76,28 @@ class GarnetNetwork
     GarnetNetwork(const Params &p);
     ~GarnetNetwork();
 
+    // Call once the topology is built: builds the routers' crossbars,
+    // compiles their routing tables and declares them to the fault model.
     void init();
 
-    EventQueue* getEventQueue() { return &m_event_queue; }
+    // Total size of the compiled routing tables.
+    size_t getRoutingTableBytes() const { return m_routing_table_bytes; }
+
+    // A thread simulating one partition of the network (see SimKernel)
+    // installs that partition's event queue and stats for itself; every
+    // other caller gets the network-wide ones.
+    EventQueue*
+    getEventQueue()
+    {
+        EventQueue* q = thread_event_queue();
+        return q ? q : &m_event_queue;
+    }
+    static void
+    setThreadPartition(EventQueue* queue, GarnetStats* stats)
+    {
+        thread_event_queue() = queue;
+        thread_stats() = stats;
+    }
 
     const char *garnetVersion = "3.0";
 
@@ -93,16 +114,33 @@ class GarnetNetwork
     uint32_t getBuffersPerCtrlVC() { return m_buffers_per_ctrl_vc; }
     int getRoutingAlgorithm() const { return m_routing_algorithm; }
     bool getDebug() const { return m_debug; }
+    bool useGenericRouterKernels() const { return m_generic_router_kernels; }
 
     bool isFaultModelEnabled() const { return m_enable_fault_model; }
     FaultModel* fault_model;
 
 
     // Internal configuration
+    // Vnets carry data unless set_vnet_type() says otherwise.
     VNET_type
     get_vnet_type(int vnet)
     {
-        return m_vnet_type[vnet];
+        return vnet < (int)m_vnet_type.size() ? m_vnet_type[vnet]
+                                               : DATA_VNET_;
+    }
+    void
+    set_vnet_type(int vnet, VNET_type type)
+    {
+        if (vnet >= (int)m_vnet_type.size())
+            m_vnet_type.resize(vnet + 1, DATA_VNET_);
+        m_vnet_type[vnet] = type;
+    }
+    // Depth of a VC's input buffer on the given vnet.
+    uint32_t
+    getBuffersPerVC(int vnet)
+    {
+        return get_vnet_type(vnet) == CTRL_VNET_ ? m_buffers_per_ctrl_vc
+                                                 : m_buffers_per_data_vc;
     }
     int getNumRouters();
     int get_router_id(int ni, int vnet);
@@ -112,23 +150,29 @@ class GarnetNetwork
     // Stats
     void print(std::ostream& out) const;
 
-    void increment_injected_packets(int vnet) { m_garnetStats.injected_packets[vnet]++; }
-    void increment_received_packets(int vnet) { m_garnetStats.received_packets[vnet]++; }
-    void increment_packet_network_latency(uint64_t latency, int vnet) { m_garnetStats.packet_network_latency[vnet] += latency; }
-    void increment_packet_queueing_latency(uint64_t latency, int vnet) { m_garnetStats.packet_queueing_latency[vnet] += latency; }
-    void increment_injected_flits(int vnet) { m_garnetStats.injected_flits[vnet]++; }
-    void increment_received_flits(int vnet) { m_garnetStats.received_flits[vnet]++; }
-    void increment_flit_network_latency(uint64_t latency, int vnet) { m_garnetStats.flit_network_latency[vnet] += latency; }
-    void increment_flit_queueing_latency(uint64_t latency, int vnet) { m_garnetStats.flit_queueing_latency[vnet] += latency; }
-    void increment_total_hops(int hops) { m_garnetStats.total_hops += hops; }
-
-    void update_traffic_distribution(RouteInfo route);
+    void increment_injected_packets(int vnet) { stats().injected_packets[vnet]++; }
+    void increment_received_packets(int vnet) { stats().received_packets[vnet]++; }
+    void increment_packet_network_latency(uint64_t latency, int vnet) { stats().packet_network_latency[vnet] += latency; }
+    void increment_packet_queueing_latency(uint64_t latency, int vnet) { stats().packet_queueing_latency[vnet] += latency; }
+    void increment_injected_flits(int vnet) { stats().injected_flits[vnet]++; }
+    void increment_received_flits(int vnet) { stats().received_flits[vnet]++; }
+    void increment_flit_network_latency(uint64_t latency, int vnet) { stats().flit_network_latency[vnet] += latency; }
+    void increment_flit_queueing_latency(uint64_t latency, int vnet) { stats().flit_queueing_latency[vnet] += latency; }
+    void increment_total_hops(int hops) { stats().total_hops += hops; }
+
+    void update_traffic_distribution(const RouteInfo& route);
+    // Packet ids only label traces; partitions draw them concurrently.
     int getNextPacketID() { return m_next_packet_id++; }
 
     bool isVNetOrdered(int vnet) { return vnet == 0; } // gem5 defaults VNet 0 to ordered
 
     GarnetStats& getStats() { return m_garnetStats; }
 
+    // Event queue, stats and packet ids; called by Topology::saveState()
+    // once the simulated objects are registered with the checkpoint.
+    void saveState(CheckpointOut& cp) const;
+    void loadState(CheckpointIn& cp);
+
   protected:
     // Configuration
     int m_num_rows;
@@ -141,12 +185,32 @@ class GarnetNetwork
     int m_routing_algorithm;
     bool m_enable_fault_model;
     bool m_debug;
+    bool m_generic_router_kernels;
 
     // Statistical variables
     GarnetStats m_garnetStats;
 
   private:
     GarnetNetwork(const GarnetNetwork& obj);
+
+    static EventQueue*&
+    thread_event_queue()
+    {
+        static thread_local EventQueue* queue = nullptr;
+        return queue;
+    }
+    static GarnetStats*&
+    thread_stats()
+    {
+        static thread_local GarnetStats* stats = nullptr;
+        return stats;
+    }
+    GarnetStats&
+    stats()
+    {
+        GarnetStats* s = thread_stats();
+        return s ? *s : m_garnetStats;
+    }
     GarnetNetwork& operator=(const GarnetNetwork& obj);
 
     EventQueue m_event_queue;
@@ -157,7 +221,8 @@ class GarnetNetwork
     std::vector<NetworkBridge *> m_networkbridges; // All network bridges
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
-    int m_next_packet_id; // static vairable for packet id allocation
+    std::atomic<int> m_next_packet_id; // static vairable for packet id allocation
+    size_t m_routing_table_bytes = 0;
 };
 
 inline std::ostream&
@@ -1,16 +1,54 @@
 #ifndef __GARNET_SIM_OBJECT_HH__
 #define __GARNET_SIM_OBJECT_HH__
 
+#include <atomic>
 #include <cstdint>
 
+#include "Checkpoint.hh"
+
 namespace garnet {
 
 class GarnetSimObject {
 public:
-    GarnetSimObject() = default;
+    // Components SimKernel's phased mode wakes in a loop of their own.
+    // OTHER objects go through the virtual wakeup().
+    enum Kind : uint8_t { OTHER, INTERFACE, ROUTER, OUTPUT_UNIT, LINK };
+
+    GarnetSimObject() : m_rank(next_rank()++) {}
     virtual ~GarnetSimObject() = default;
 
     virtual void wakeup() = 0;
+
+    // Construction order.  Events of the same cycle are dispatched in rank
+    // order, so the order does not depend on who scheduled them first.
+    uint64_t get_rank() const { return m_rank; }
+
+    Kind get_kind() const { return m_kind; }
+
+    // Cycle of the latest wakeup this object has waiting in the event
+    // queue, or (uint64_t)-1 if none.  EventQueue uses it to drop
+    // duplicate requests for the same cycle.
+    uint64_t get_pending_wakeup() const { return m_pending_wakeup; }
+    void set_pending_wakeup(uint64_t time) { m_pending_wakeup = time; }
+
+    // Checkpointing (see Checkpoint.hh).  Overrides call their base class
+    // first, then handle their own fields.
+    virtual void saveState(CheckpointOut& cp) const { cp.put(m_pending_wakeup); }
+    virtual void loadState(CheckpointIn& cp) { cp.get(m_pending_wakeup); }
+
+protected:
+    void set_kind(Kind kind) { m_kind = kind; }
+
+private:
+    static std::atomic<uint64_t>& next_rank()
+    {
+        static std::atomic<uint64_t> rank(0);
+        return rank;
+    }
+
+    const uint64_t m_rank;
+    uint64_t m_pending_wakeup = (uint64_t)-1;
+    Kind m_kind = OTHER;
 };
 
 } // namespace garnet
@@ -34,6 +34,20 @@ struct GarnetStats {
         }
         total_hops = 0;
     }
+
+    void merge(const GarnetStats& o) {
+        for (int i = 0; i < NUM_STAT_VNETS; ++i) {
+            injected_packets[i]        += o.injected_packets[i];
+            received_packets[i]        += o.received_packets[i];
+            packet_network_latency[i]  += o.packet_network_latency[i];
+            packet_queueing_latency[i] += o.packet_queueing_latency[i];
+            injected_flits[i]          += o.injected_flits[i];
+            received_flits[i]          += o.received_flits[i];
+            flit_network_latency[i]    += o.flit_network_latency[i];
+            flit_queueing_latency[i]   += o.flit_queueing_latency[i];
+        }
+        total_hops += o.total_hops;
+    }
     
     void print(std::ostream& out) const {
         out << "Global Simulation Statistics:\n";
@@ -31,6 +31,8 @@
 
 #include "InputUnit.hh"
 
+#include <algorithm>
+
 #include "Credit.hh"
 #include "Router.hh"
 #include "GarnetNetwork.hh"
@@ -40,14 +42,34 @@ namespace garnet
 
 InputUnit::InputUnit(int id, PortDirection direction, Router *router)
   : m_router(router), m_id(id), m_direction(direction),
-    m_vc_per_vnet(m_router->get_vc_per_vnet())
+    m_vc_per_vnet(m_router->get_vc_per_vnet()),
+    m_num_vcs(m_router->get_num_vcs())
 {
-    const int m_num_vcs = m_router->get_num_vcs();
-    // Instantiating the virtual channels
-    virtualChannels.reserve(m_num_vcs);
-    for (int i=0; i < m_num_vcs; i++) {
-        virtualChannels.emplace_back();
+    // Instantiating the virtual channels next to this unit
+    virtualChannels =
+        m_router->getArena().create_array<VirtualChannel>(m_num_vcs);
+    // Each buffered flit, and each credit it returns upstream, was paid
+    // for with a slot of some VC, so the VC depths bound both.
+    GarnetNetwork *net = m_router->get_net_ptr();
+    int credits = 0;
+    for (int vc = 0; vc < m_num_vcs; vc++) {
+        int depth = net->getBuffersPerVC(vc / m_vc_per_vnet);
+        virtualChannels[vc].set_depth(depth);
+        credits += depth;
     }
+    creditQueue.setMaxSize(credits);
+    m_occupied_vcs.resize(m_num_vcs);
+    m_ordered_vcs.resize(m_num_vcs);
+    m_older_vc.assign(m_num_vcs, -1);
+    m_newer_vc.assign(m_num_vcs, -1);
+}
+
+// Sizes the ordered-vnet lists once the router has all its outports.
+void
+InputUnit::init()
+{
+    m_num_outports = m_router->get_num_outports();
+    rebuild_ordered_vcs();
 }
 
 InputUnit::~InputUnit()
@@ -82,13 +104,13 @@ InputUnit::wakeup()
 
         if (t_flit->get_trace()) {
             std::cout << "TRACE: Packet " << t_flit->getPacketID() << " (Flit " << t_flit->get_id() << ") ARRIVED at Router " << m_router->get_id() 
-                      << " (" << m_router->get_x() << "," << m_router->get_y() << "," << m_router->get_z() << ") at port " << m_direction 
+                      << " (" << m_router->get_x() << "," << m_router->get_y() << "," << m_router->get_z() << ") at port " << portDirectionName(m_direction) 
                       << " at time " << current_time << std::endl;
         }
 
         if (m_router->get_net_ptr()->getDebug()) {
              std::cout << "[Cycle " << current_time << "] Router " << m_router->get_id() 
-                      << " RECEIVED flit " << t_flit->get_id() << " at port " << m_direction << std::endl;
+                      << " RECEIVED flit " << t_flit->get_id() << " at port " << portDirectionName(m_direction) << std::endl;
         }
 
         if ((t_flit->get_type() == HEAD_) ||
@@ -108,6 +130,9 @@ InputUnit::wakeup()
             // The output port field in the flit is updated after it wins SA
             grant_outport(vc, outport);
 
+            if (m_router->get_net_ptr()->isVNetOrdered(vc / m_vc_per_vnet))
+                link_ordered_vc(vc);
+
         } else {
             assert(virtualChannels[vc].get_state() == ACTIVE_);
         }
@@ -115,6 +140,8 @@ InputUnit::wakeup()
 
         // Buffer the flit
         virtualChannels[vc].insertFlit(t_flit);
+        m_occupied_vcs.set(vc);
+        m_router->increment_buffered_flits();
 
         uint64_t pipe_stages = m_router->get_pipe_stages();
         if (pipe_stages == 1) {
@@ -149,15 +176,98 @@ InputUnit::increment_credit(int in_vc, bool free_signal, uint64_t curTime)
     m_credit_link->scheduleEvent(1);
 }
 
+// Appends the packet just activated in `vc` to its (vnet, outport) list.
+void
+InputUnit::link_ordered_vc(int vc)
+{
+    if (m_ordered_vcs.test(vc))
+        unlink_ordered_vc(vc);
+    int &newest = m_newest_vc[(vc / m_vc_per_vnet) * m_num_outports +
+                              virtualChannels[vc].get_outport()];
+    m_older_vc[vc] = newest;
+    m_newer_vc[vc] = -1;
+    if (newest != -1)
+        m_newer_vc[newest] = vc;
+    newest = vc;
+    m_ordered_vcs.set(vc);
+}
+
+// Packets can leave out of order (an older one may wait for its body
+// flits), so `vc` may sit anywhere in its list.
+void
+InputUnit::unlink_ordered_vc(int vc)
+{
+    int older = m_older_vc[vc];
+    int newer = m_newer_vc[vc];
+    if (older != -1)
+        m_newer_vc[older] = newer;
+    if (newer != -1) {
+        m_older_vc[newer] = older;
+    } else {
+        m_newest_vc[(vc / m_vc_per_vnet) * m_num_outports +
+                    virtualChannels[vc].get_outport()] = older;
+    }
+    m_older_vc[vc] = m_newer_vc[vc] = -1;
+    m_ordered_vcs.reset(vc);
+}
+
+// Relinks the active VCs of ordered vnets by the cycle their packet
+// arrived in.
+void
+InputUnit::rebuild_ordered_vcs()
+{
+    m_ordered_vcs.clear();
+    std::fill(m_older_vc.begin(), m_older_vc.end(), -1);
+    std::fill(m_newer_vc.begin(), m_newer_vc.end(), -1);
+    m_newest_vc.assign(m_router->get_num_vnets() * m_num_outports, -1);
+
+    std::vector<int> active;
+    for (int vc = 0; vc < m_num_vcs; vc++) {
+        VirtualChannel &t_vc = virtualChannels[vc];
+        if (t_vc.get_state() == ACTIVE_ && t_vc.get_outport() >= 0 &&
+            t_vc.get_outport() < m_num_outports &&
+            m_router->get_net_ptr()->isVNetOrdered(vc / m_vc_per_vnet))
+            active.push_back(vc);
+    }
+    std::stable_sort(active.begin(), active.end(), [this](int a, int b) {
+        return virtualChannels[a].get_enqueue_time() <
+               virtualChannels[b].get_enqueue_time();
+    });
+    for (int vc : active)
+        link_ordered_vc(vc);
+}
+
 bool
 InputUnit::has_pending_flits() const
 {
-    for (const auto& vc : virtualChannels) {
-        if (!vc.getInputBuffer().isEmpty()) {
+    for (int vc = 0; vc < m_num_vcs; vc++) {
+        if (!virtualChannels[vc].getInputBuffer().isEmpty()) {
             return true;
         }
     }
     return false;
 }
 
+void
+InputUnit::saveState(CheckpointOut& cp) const
+{
+    GarnetSimObject::saveState(cp);
+    creditQueue.saveState(cp);
+    for (int vc = 0; vc < m_num_vcs; vc++) virtualChannels[vc].saveState(cp);
+}
+
+void
+InputUnit::loadState(CheckpointIn& cp)
+{
+    GarnetSimObject::loadState(cp);
+    creditQueue.loadState(cp);
+    m_occupied_vcs.clear();
+    for (int vc = 0; vc < m_num_vcs; vc++) {
+        virtualChannels[vc].loadState(cp);
+        if (!virtualChannels[vc].getInputBuffer().isEmpty())
+            m_occupied_vcs.set(vc);
+    }
+    rebuild_ordered_vcs();
+}
+
 } // namespace garnet
\ No newline at end of file
@@ -36,6 +36,7 @@
 #include <vector>
 #include <cstdint>
 
+#include "BitMask.hh"
 #include "CommonTypes.hh"
 #include "CreditLink.hh"
 #include "NetworkLink.hh"
@@ -53,14 +54,20 @@ class InputUnit : public GarnetSimObject
     InputUnit(int id, PortDirection direction, Router *router);
     ~InputUnit();
 
-    void wakeup();
+    void init();
+    void wakeup() final;
     void print(std::ostream& out) const {};
 
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp) override;
+
     inline PortDirection get_direction() { return m_direction; }
 
     inline void
     set_vc_idle(int vc, uint64_t curTime)
     {
+        if (m_ordered_vcs.test(vc))
+            unlink_ordered_vc(vc);
         virtualChannels[vc].set_idle(curTime);
     }
 
@@ -100,6 +107,14 @@ class InputUnit : public GarnetSimObject
         return virtualChannels[invc].get_enqueue_time();
     }
 
+    // In an ordered vnet, the packet that arrived on this port just before
+    // the one in `invc` and heads for the same outport; -1 if none.
+    inline int
+    get_older_vc(int invc)
+    {
+        return m_older_vc[invc];
+    }
+
     void increment_credit(int in_vc, bool free_signal, uint64_t curTime);
 
     bool has_pending_flits() const;
@@ -113,9 +128,15 @@ class InputUnit : public GarnetSimObject
     inline flit*
     getTopFlit(int vc)
     {
-        return virtualChannels[vc].getTopFlit();
+        flit *t_flit = virtualChannels[vc].getTopFlit();
+        if (virtualChannels[vc].getInputBuffer().isEmpty())
+            m_occupied_vcs.reset(vc);
+        return t_flit;
     }
 
+    // VCs holding at least one flit.
+    const BitMask& occupied_vcs() const { return m_occupied_vcs; }
+
     inline bool
     need_stage(int vc, flit_stage stage, uint64_t time)
     {
@@ -137,6 +158,7 @@ class InputUnit : public GarnetSimObject
     }
 
     inline int get_inlink_id() { return m_in_link->get_id(); }
+    CreditLink* get_credit_link() { return m_credit_link; }
 
     inline void
     set_credit_link(CreditLink *credit_link)
@@ -153,8 +175,23 @@ class InputUnit : public GarnetSimObject
     CreditLink *m_credit_link;
     flitBuffer creditQueue;
 
-    // Input Virtual channels
-    std::vector<VirtualChannel> virtualChannels;
+    void link_ordered_vc(int vc);
+    void unlink_ordered_vc(int vc);
+    void rebuild_ordered_vcs();
+
+    // Input Virtual channels, in the router's arena
+    VirtualChannel *virtualChannels;
+    int m_num_vcs;
+    BitMask m_occupied_vcs;
+
+    // Active VCs of ordered vnets, one arrival-ordered list per vnet and
+    // outport, linked through m_older_vc / m_newer_vc.  m_newest_vc holds
+    // the tail of every list, indexed [vnet * num_outports + outport].
+    int m_num_outports = 0;
+    BitMask m_ordered_vcs;
+    std::vector<int> m_older_vc;
+    std::vector<int> m_newer_vc;
+    std::vector<int> m_newest_vc;
 };
 
 } // namespace garnet
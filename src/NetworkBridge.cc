@@ -42,6 +42,7 @@ namespace garnet
 NetworkBridge::NetworkBridge(const Params &p)
     :CreditLink(p)
 {
+    set_kind(OTHER);    // overrides wakeup()
     enCdc = true;
     enSerDes = true;
     mType = 0; // Default
@@ -50,6 +51,7 @@ NetworkBridge::NetworkBridge(const Params &p)
     serDesLatency = 1;
     lastScheduledAt = 0;
 
+    coBridge = nullptr;
     nLink = nullptr; 
 }
 
@@ -91,8 +93,28 @@ NetworkBridge::scheduleFlit(flit *t_flit, uint64_t latency)
     sendTime = std::max(lastScheduledAt + 1, sendTime);
     t_flit->set_time(sendTime);
     lastScheduledAt = sendTime;
-    linkBuffer.insert(t_flit);
-    link_consumer->scheduleEvent(totLatency);
+    if (m_outbox) {
+        bool queued = m_outbox->push(t_flit);
+        assert(queued);
+        (void)queued;
+    } else {
+        deliver(t_flit);
+    }
+}
+
+uint64_t
+NetworkBridge::get_min_delay() const
+{
+    return (enCdc ? cdcLatency : 0) + (enSerDes ? serDesLatency : 0);
+}
+
+int
+NetworkBridge::get_max_flits_per_wakeup() const
+{
+    if (!enSerDes || !nLink) return 1;
+    uint32_t wide = std::max(bitWidth, nLink->bitWidth);
+    uint32_t narrow = std::max<uint32_t>(1, std::min(bitWidth, nLink->bitWidth));
+    return (int)((wide + narrow - 1) / narrow);
 }
 
 void
@@ -136,7 +158,7 @@ NetworkBridge::flitisizeAndSend(flit *t_flit)
                        t_flit->get_type() == HEAD_TAIL_) {
                 // If its the end of packet, then send whatever
                 // is available.
-                int sizeAvail = (t_flit->msgSize - sizeSent[vc]);
+                int sizeAvail = (t_flit->get_msg_size() - sizeSent[vc]);
                 flitPossible = ceil((float)sizeAvail/(float)target_width);
                 assert (flitPossible < 2);
                 num_flits = (t_flit->get_id() + 1) - flitsSent[vc];
@@ -197,7 +219,7 @@ NetworkBridge::flitisizeAndSend(flit *t_flit)
                     flitsSent[vc] += flitPossible;
                 }
             } else {
-                int sizeAvail = t_flit->msgSize - sizeSent[vc];
+                int sizeAvail = t_flit->get_msg_size() - sizeSent[vc];
                 flitPossible = ceil((float)sizeAvail/(float)target_width);
                 sizeSent[vc] = 0;
                 flitsSent[vc] = 0;
@@ -240,4 +262,38 @@ NetworkBridge::wakeup()
     }
 }
 
+void
+NetworkBridge::saveState(CheckpointOut& cp) const
+{
+    CreditLink::saveState(cp);
+    cp.put(lastScheduledAt);
+    cp.put(lenBuffer);
+    cp.put(sizeSent);
+    cp.put(flitsSent);
+    for (std::queue<int> credits : extraCredit) {
+        cp.put((uint64_t)credits.size());
+        for (; !credits.empty(); credits.pop()) cp.put(credits.front());
+    }
+}
+
+void
+NetworkBridge::loadState(CheckpointIn& cp)
+{
+    CreditLink::loadState(cp);
+    cp.get(lastScheduledAt);
+    cp.get(lenBuffer);
+    cp.get(sizeSent);
+    cp.get(flitsSent);
+    for (auto& credits : extraCredit) {
+        credits = std::queue<int>();
+        uint64_t size = 0;
+        cp.get(size);
+        for (uint64_t i = 0; i < size && cp.ok(); ++i) {
+            int credit = 0;
+            cp.get(credit);
+            credits.push(credit);
+        }
+    }
+}
+
 } // namespace garnet
\ No newline at end of file
@@ -68,6 +68,14 @@ class NetworkBridge: public CreditLink
     void flitisizeAndSend(flit *t_flit);
     void setVcsPerVnet(uint32_t consumerVcs);
 
+    // CDC and serdes delay; a serializer sends up to the width ratio.
+    uint64_t get_min_delay() const override;
+    int get_max_flits_per_wakeup() const override;
+    NetworkBridge *getCoBridge() const { return coBridge; }
+
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp) override;
+
   protected:
     // Pointer to co-existing bridge
     // CreditBridge for Network Bridge and vice versa
@@ -26,9 +26,12 @@ NetworkInterface::NetworkInterface(const Params &p)
     m_vc_allocator(m_virtual_networks, 0),
     m_deadlock_threshold(p.deadlock_threshold)
 {
+    set_kind(INTERFACE);
     m_net_ptr = p.net_ptr;
     m_stall_count.resize(m_virtual_networks);
     m_traffic_generator = nullptr; 
+    m_polled_until = 0;
+    m_queued_flits = 0;
     m_vnet_to_vc_map.resize(m_virtual_networks, -1); 
 }
 
@@ -45,7 +48,34 @@ NetworkInterface::~NetworkInterface()
     }
 }
 
-void NetworkInterface::setTrafficGenerator(TrafficGenerator* tg) { m_traffic_generator = tg; }
+void NetworkInterface::setTrafficGenerator(TrafficGenerator* tg)
+{
+    m_traffic_generator = tg;
+    m_polled_until = 0;
+}
+
+uint64_t NetworkInterface::get_next_active_time() const
+{
+    uint64_t current_time = m_net_ptr->getEventQueue()->get_current_time();
+    if (m_queued_flits > 0 || has_inbound())
+        return current_time;
+    for (auto &iPort : inPorts) {
+        if (!iPort->outCreditQueue()->isEmpty())
+            return current_time;
+    }
+    if (!m_traffic_generator)
+        return (uint64_t)-1;
+    return m_traffic_generator->get_next_injection_time();
+}
+
+void NetworkInterface::sync_idle_cycles(uint64_t until)
+{
+    if (until > m_polled_until) {
+        if (m_traffic_generator)
+            m_traffic_generator->skip_idle_cycles(until - m_polled_until);
+        m_polled_until = until;
+    }
+}
 
 void NetworkInterface::init() { /* NIC initialization if needed */ }
 
@@ -71,11 +101,10 @@ void NetworkInterface::addOutPort(NetworkLink *out_link, CreditLink *credit_link
         m_vc_per_vnet = consumerVcs;
         int m_num_vcs = consumerVcs * m_virtual_networks;
         niOutVcs.resize(m_num_vcs); 
-        outVcState.reserve(m_num_vcs);
+        outVcState = OutVcState(m_num_vcs, consumerVcs);
         m_ni_out_vcs_enqueue_time.resize(m_num_vcs);
         for (int i = 0; i < m_num_vcs; i++) {
             m_ni_out_vcs_enqueue_time[i] = (uint64_t)-1; 
-            outVcState.emplace_back(i, m_net_ptr, consumerVcs);
         }
         for (auto &iPort: inPorts) {
             iPort->inNetLink()->setVcsPerVnet(m_vc_per_vnet);
@@ -93,6 +122,10 @@ void NetworkInterface::wakeup()
 {
     assert(m_traffic_generator != nullptr);
 
+    uint64_t now = m_net_ptr->getEventQueue()->get_current_time();
+    sync_idle_cycles(now);
+    m_polled_until = now + 1;
+
     flit* ejected_flit = flit_eject();
     if (ejected_flit) {
         m_net_ptr->increment_received_flits(ejected_flit->get_vnet());
@@ -126,9 +159,9 @@ void NetworkInterface::wakeup()
         CreditLink *inCreditLink = oPort->inCreditLink();
         if (inCreditLink->isReady(current_time)) {
             Credit *t_credit = (Credit*) inCreditLink->consumeLink();
-            outVcState[t_credit->get_vc()].increment_credit();
+            outVcState.increment_credit(t_credit->get_vc());
             if (t_credit->is_free_signal()) {
-                outVcState[t_credit->get_vc()].setState(IDLE_, current_time);
+                outVcState.set_idle(t_credit->get_vc());
             }
             delete t_credit;
         }
@@ -145,18 +178,12 @@ void NetworkInterface::wakeup()
 
 int NetworkInterface::calculateVC(int vnet)
 {
-    for (int i = 0; i < m_vc_per_vnet; i++) {
-        int delta = m_vc_allocator[vnet];
-        m_vc_allocator[vnet]++;
-        if (m_vc_allocator[vnet] == m_vc_per_vnet)
-            m_vc_allocator[vnet] = 0;
-
-        if (outVcState[(vnet*m_vc_per_vnet) + delta].isInState(
-                    IDLE_, m_net_ptr->getEventQueue()->get_current_time())) {
-            return ((vnet*m_vc_per_vnet) + delta);
-        }
-    }
-    return -1;
+    // Round robin over the vnet's idle VCs, starting at the allocator.
+    int vc = outVcState.find_idle(vnet, m_vc_allocator[vnet]);
+    if (vc == -1) return -1;
+    int delta = vc - vnet * m_vc_per_vnet;
+    m_vc_allocator[vnet] = (delta + 1 == m_vc_per_vnet) ? 0 : delta + 1;
+    return vc;
 }
 
 bool NetworkInterface::flit_inj(flit* flt)
@@ -176,11 +203,12 @@ bool NetworkInterface::flit_inj(flit* flt)
         if (vc == -1) return false;
         
         m_vnet_to_vc_map[vnet] = vc; 
-        outVcState[vc].setState(ACTIVE_, current_time);
+        outVcState.set_active(vc);
     }
 
     flt->set_vc(vc);
     niOutVcs[vc].insert(flt);
+    m_queued_flits++;
     m_ni_out_vcs_enqueue_time[vc] = current_time;
 
     if (flt->get_type() == TAIL_ || flt->get_type() == HEAD_TAIL_) {
@@ -192,27 +220,27 @@ bool NetworkInterface::flit_inj(flit* flt)
 
 void NetworkInterface::scheduleOutputPort(OutputPort *oPort)
 {
-   int vc = oPort->vcRoundRobin();
+   int num_vcs = (int)niOutVcs.size();
+   if (num_vcs == 0) return;
    uint64_t current_time = m_net_ptr->getEventQueue()->get_current_time();
 
-   for (int i = 0; i < (int)niOutVcs.size(); i++) {
-       vc = (vc + 1) % niOutVcs.size();
-
-       int t_vnet = get_vnet(vc);
-       if (oPort->isVnetSupported(t_vnet)) {
-           if (niOutVcs[vc].isReady(current_time) && outVcState[vc].has_credit()) {
-               oPort->vcRoundRobin(vc);
-               outVcState[vc].decrement_credit();
-               flit *t_flit = niOutVcs[vc].getTopFlit();
-               t_flit->set_time(current_time);
-               scheduleFlit(t_flit);
-
-               if (t_flit->get_type() == TAIL_ || t_flit->get_type() == HEAD_TAIL_) {
-                   m_ni_out_vcs_enqueue_time[vc] = (uint64_t)-1;
-               }
-               return;
-           }
-       }
+   // Round robin from the VC after the last one sent, over VCs with credit.
+   int vc = outVcState.credit_mask().find_from(
+       (oPort->vcRoundRobin() + 1) % num_vcs, [&](int vc) {
+           return oPort->isVnetSupported(get_vnet(vc)) &&
+                  niOutVcs[vc].isReady(current_time);
+       });
+   if (vc == -1) return;
+
+   oPort->vcRoundRobin(vc);
+   outVcState.decrement_credit(vc);
+   flit *t_flit = niOutVcs[vc].getTopFlit();
+   m_queued_flits--;
+   t_flit->set_time(current_time);
+   scheduleFlit(t_flit);
+
+   if (t_flit->get_type() == TAIL_ || t_flit->get_type() == HEAD_TAIL_) {
+       m_ni_out_vcs_enqueue_time[vc] = (uint64_t)-1;
    }
 }
 
@@ -268,6 +296,61 @@ flit* NetworkInterface::flit_eject()
 void NetworkInterface::print(std::ostream& out) const { out << "[NI]"; }
 void NetworkInterface::scheduleEvent(uint64_t time) { m_net_ptr->getEventQueue()->schedule(this, time); }
 
+void NetworkInterface::saveState(CheckpointOut& cp) const
+{
+    Consumer::saveState(cp);
+    cp.put(m_vc_allocator);
+    outVcState.saveState(cp);
+    cp.put(m_stall_count);
+    for (const auto& buffer : niOutVcs) buffer.saveState(cp);
+    cp.put(m_ni_out_vcs_enqueue_time);
+    cp.put(m_vnet_to_vc_map);
+    cp.put(m_polled_until);
+    cp.put(m_queued_flits);
+    for (auto oPort : outPorts) {
+        cp.put(oPort->vcRoundRobin());
+        oPort->outFlitQueue()->saveState(cp);
+    }
+    for (auto iPort : inPorts) iPort->outCreditQueue()->saveState(cp);
+    cp.put(m_traffic_generator != nullptr);
+    if (m_traffic_generator) m_traffic_generator->saveState(cp);
+}
+
+void NetworkInterface::loadState(CheckpointIn& cp)
+{
+    Consumer::loadState(cp);
+    cp.get(m_vc_allocator);
+    outVcState.loadState(cp);
+    cp.get(m_stall_count);
+    for (auto& buffer : niOutVcs) buffer.loadState(cp);
+    cp.get(m_ni_out_vcs_enqueue_time);
+    cp.get(m_vnet_to_vc_map);
+    cp.get(m_polled_until);
+    cp.get(m_queued_flits);
+    for (auto oPort : outPorts) {
+        int vc = 0;
+        cp.get(vc);
+        oPort->vcRoundRobin(vc);
+        oPort->outFlitQueue()->loadState(cp);
+    }
+    for (auto iPort : inPorts) iPort->outCreditQueue()->loadState(cp);
+    bool has_generator = false;
+    cp.get(has_generator);
+    if (has_generator != (m_traffic_generator != nullptr))
+        cp.fail("traffic generator mismatch at NI " + std::to_string(m_id));
+    else if (m_traffic_generator)
+        m_traffic_generator->loadState(cp);
+}
+
+std::vector<NetworkLink*>
+NetworkInterface::getOutboundLinks()
+{
+    std::vector<NetworkLink*> links;
+    for (auto oPort : outPorts) links.push_back(oPort->outNetLink());
+    for (auto iPort : inPorts)  links.push_back(iPort->outCreditLink());
+    return links;
+}
+
 NetworkInterface::OutputPort::OutputPort(NetworkLink *outLink, CreditLink *creditLink, int routerID)
 { _vnets = outLink->mVnets; _outFlitQueue = new flitBuffer(); _outNetLink = outLink; _inCreditLink = creditLink; _routerID = routerID; _bitWidth = outLink->bitWidth; _vcRoundRobin = 0; }
 NetworkInterface::OutputPort::~OutputPort() { while(!_outFlitQueue->isEmpty()) delete _outFlitQueue->getTopFlit(); delete _outFlitQueue; }
@@ -53,7 +53,7 @@ class NetworkInterface : public Consumer
                     SwitchID router_id, uint32_t consumerVcs);
 
     void init(); // Added init method
-    void wakeup();
+    void wakeup() final;
 
     // New interface for traffic generators
     bool flit_inj(flit *flt);
@@ -62,8 +62,19 @@ class NetworkInterface : public Consumer
     // Attach a traffic generator (SimpleTrafficGenerator or PaceTrafficGenerator).
     void setTrafficGenerator(TrafficGenerator *tg);
 
+    // Earliest cycle at which wakeup() has work: now while flits or
+    // credits are buffered here or in flight towards this NI, otherwise
+    // the traffic generator's next injection time.
+    uint64_t get_next_active_time() const;
+
+    // Hand the generator the cycles in [m_polled_until, until) on which
+    // this NI was skipped because it had no work.
+    void sync_idle_cycles(uint64_t until);
+
     void print(std::ostream &out) const;
     int get_vnet(int vc);
+    // Flits the router can buffer for this NI's injection port.
+    int get_total_credits() const { return outVcState.get_total_credits(); }
     NodeID get_id() const { return m_id; }
 
     int get_x() const { return m_x; }
@@ -72,6 +83,13 @@ class NetworkInterface : public Consumer
 
     void scheduleEvent(uint64_t time) override;
 
+    // Flit and credit links fed by this NI.
+    std::vector<NetworkLink*> getOutboundLinks();
+
+    // Includes the attached traffic generator.
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp) override;
+
     void scheduleFlit(flit *t_flit);
 
     int get_router_id(int vnet)
@@ -254,7 +272,7 @@ class NetworkInterface : public Consumer
     std::vector<OutputPort *> outPorts;
     std::vector<InputPort *> inPorts;
     int m_deadlock_threshold;
-    std::vector<OutVcState> outVcState;
+    OutVcState outVcState;
 
     std::vector<int> m_stall_count;
 
@@ -267,6 +285,10 @@ class NetworkInterface : public Consumer
 
     // Pointer to the traffic generator (SimpleTrafficGenerator or PaceTrafficGenerator).
     TrafficGenerator* m_traffic_generator;
+    // First cycle the generator has not been polled (or synced) for.
+    uint64_t m_polled_until;
+    // Flits waiting in niOutVcs.
+    uint64_t m_queued_flits;
 
     void checkStallQueue();
 
@@ -7,6 +7,9 @@
  */
 
 #include "NetworkLink.hh"
+
+#include <cassert>
+
 #include "GarnetNetwork.hh"
 #include "Consumer.hh"
 #include "CreditLink.hh"
@@ -23,6 +26,7 @@ NetworkLink::NetworkLink(const Params &p)
       m_virt_nets(p.virtual_networks), linkBuffer(),
       link_consumer(nullptr), link_srcQueue(nullptr)
 {
+    set_kind(LINK);
     m_net_ptr = p.net_ptr;
 }
 
@@ -38,14 +42,27 @@ void NetworkLink::setVcsPerVnet(uint32_t consumerVcs) { m_vc_load.resize(m_virt_
 void NetworkLink::setSourceQueue(flitBuffer *src_queue) { link_srcQueue = src_queue; }
 void NetworkLink::scheduleEvent(uint64_t time) { m_net_ptr->getEventQueue()->schedule(this, time); }
 
+void
+NetworkLink::deliver(flit *t_flit)
+{
+    linkBuffer.insert(t_flit);
+    link_consumer->inbound_enqueued();
+    m_net_ptr->getEventQueue()->schedule_at(link_consumer, t_flit->get_time());
+}
+
 void
 NetworkLink::wakeup()
 {
     if (link_srcQueue->isReady(m_net_ptr->getEventQueue()->get_current_time())) {
         flit *t_flit = link_srcQueue->getTopFlit();
         t_flit->set_time(m_net_ptr->getEventQueue()->get_current_time() + m_latency);
-        linkBuffer.insert(t_flit);
-        link_consumer->scheduleEvent(m_latency);
+        if (m_outbox) {
+            bool queued = m_outbox->push(t_flit);
+            assert(queued);
+            (void)queued;
+        } else {
+            deliver(t_flit);
+        }
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
     }
@@ -55,4 +72,22 @@ NetworkLink::wakeup()
     }
 }
 
+void
+NetworkLink::saveState(CheckpointOut& cp) const
+{
+    GarnetSimObject::saveState(cp);
+    linkBuffer.saveState(cp);
+    cp.put(m_link_utilized);
+    cp.put(m_vc_load);
+}
+
+void
+NetworkLink::loadState(CheckpointIn& cp)
+{
+    GarnetSimObject::loadState(cp);
+    linkBuffer.loadState(cp);
+    cp.get(m_link_utilized);
+    cp.get(m_vc_load);
+}
+
 } // namespace garnet
\ No newline at end of file
@@ -33,19 +33,21 @@
 #ifndef __GARNET_NETWORK_LINK_HH__
 #define __GARNET_NETWORK_LINK_HH__
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <cstdint>
 
 #include "CommonTypes.hh"
+#include "Consumer.hh"
 #include "flitBuffer.hh"
 #include "GarnetSimObject.hh"
+#include "SpscQueue.hh"
 
 namespace garnet
 {
 
 class GarnetNetwork;
-class Consumer;
 
 struct NetworkLinkParams {
     int id;
@@ -69,11 +71,35 @@ class NetworkLink : public GarnetSimObject
     link_type getType() { return m_type; }
     void print(std::ostream& out) const {}
     int get_id() const { return m_id; }
+    uint64_t get_latency() const { return m_latency; }
+    Consumer *getLinkConsumer() { return link_consumer; }
     flitBuffer *getBuffer() { return &linkBuffer;}
     virtual void wakeup();
 
+    // Set by SimKernel when the consumer is simulated by another thread:
+    // wakeup() then parks departing flits in the outbox, and the consumer's
+    // thread hands them to deliver() at the next partition barrier.
+    void setOutbox(SpscQueue<flit*> *outbox) { m_outbox = outbox; }
+    // Puts a flit that left the source on the wire towards the consumer.
+    void deliver(flit *t_flit);
+    // What SimKernel needs to put the consumer in another partition: the
+    // fewest cycles from wakeup() taking a flit to the flit reaching the
+    // consumer, and the most flits one wakeup() sends.
+    virtual uint64_t get_min_delay() const { return m_latency; }
+    virtual int get_max_flits_per_wakeup() const { return 1; }
+
     unsigned int getLinkUtilization() const { return m_link_utilized; }
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
+    void resetStats()
+    {
+        m_link_utilized = 0;
+        std::fill(m_vc_load.begin(), m_vc_load.end(), 0);
+    }
+
+    // The outbox is not saved: checkpoints are taken between kernel runs,
+    // when every outbox is empty.
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp) override;
 
     inline bool isReady(uint64_t curTime)
     {
@@ -81,7 +107,12 @@ class NetworkLink : public GarnetSimObject
     }
 
     inline flit* peekLink() { return linkBuffer.peekTopFlit(); }
-    inline flit* consumeLink() { return linkBuffer.getTopFlit(); }
+    inline flit*
+    consumeLink()
+    {
+        link_consumer->inbound_dequeued();
+        return linkBuffer.getTopFlit();
+    }
 
     std::vector<int> mVnets;
     uint32_t bitWidth;
@@ -101,6 +132,7 @@ class NetworkLink : public GarnetSimObject
     flitBuffer linkBuffer;
     Consumer *link_consumer;
     flitBuffer *link_srcQueue;
+    SpscQueue<flit*> *m_outbox = nullptr;
 
 };
 
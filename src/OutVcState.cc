@@ -29,49 +29,70 @@
 
 
 #include "OutVcState.hh"
-#include <cassert>
 
-#include <cmath>
-#include "GarnetNetwork.hh"
+#include <algorithm>
+
+#include "Checkpoint.hh"
 
 namespace garnet
 {
 
-OutVcState::OutVcState(int id, GarnetNetwork *network_ptr,
-    uint32_t consumerVcs)
-    : m_time(0)
+OutVcState::OutVcState(int num_vcs, int vcs_per_vnet, Arena* arena)
+    : m_vcs_per_vnet(vcs_per_vnet), m_credit_count(arena),
+      m_idle(num_vcs, arena), m_has_credit(num_vcs, arena)
 {
-    m_id = id;
-    m_vc_state = IDLE_;
-    /*
-     * We find the virtual network using the number of
-     * vcs per vnet. This assumes that the same vcs per
-     * vnet is used throughout the given object.
-     */
-    int vnet = floor(id/consumerVcs);
-
     m_max_credit_count = 1; // Default value for standalone version
     // if (network_ptr->get_vnet_type(vnet) == DATA_VNET_)
     //     m_max_credit_count = network_ptr->getBuffersPerDataVC();
     // else
     //     m_max_credit_count = network_ptr->getBuffersPerCtrlVC();
 
-    m_credit_count = m_max_credit_count;
-    assert(m_credit_count >= 1);
+    m_credit_count.assign(num_vcs, m_max_credit_count);
+    for (int vc = 0; vc < num_vcs; vc++) {
+        m_idle.set(vc);
+        m_has_credit.set(vc);
+    }
+}
+
+int
+OutVcState::find_idle(int vnet, int start) const
+{
+    int vc_base = vnet * m_vcs_per_vnet;
+    int vc_end = vc_base + m_vcs_per_vnet;
+    int vc = m_idle.find_next(vc_base + start);
+    if (vc != -1 && vc < vc_end) return vc;
+    vc = m_idle.find_next(vc_base);
+    return (vc != -1 && vc < vc_base + start) ? vc : -1;
 }
 
 void
-OutVcState::increment_credit()
+OutVcState::saveState(CheckpointOut& cp) const
 {
-    m_credit_count++;
-    assert(m_credit_count <= m_max_credit_count);
+    std::vector<uint8_t> idle;
+    for (int vc = 0; vc < (int)m_credit_count.size(); vc++)
+        idle.push_back(m_idle.test(vc));
+    cp.put(idle);
+    cp.put(std::vector<int>(m_credit_count.begin(), m_credit_count.end()));
 }
 
 void
-OutVcState::decrement_credit()
+OutVcState::loadState(CheckpointIn& cp)
 {
-    m_credit_count--;
-    assert(m_credit_count >= 0);
+    std::vector<uint8_t> idle;
+    std::vector<int> credit_count;
+    cp.get(idle);
+    cp.get(credit_count);
+    if (idle.size() != m_credit_count.size() ||
+        credit_count.size() != m_credit_count.size()) {
+        cp.fail("output VC count does not match the network");
+        return;
+    }
+    std::copy(credit_count.begin(), credit_count.end(), m_credit_count.begin());
+    for (int vc = 0; vc < (int)m_credit_count.size(); vc++) {
+        if (idle[vc]) m_idle.set(vc); else m_idle.reset(vc);
+        if (m_credit_count[vc] > 0) m_has_credit.set(vc);
+        else m_has_credit.reset(vc);
+    }
 }
 
 } // namespace garnet
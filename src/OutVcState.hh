@@ -31,44 +31,84 @@
 #ifndef __GARNET_OUT_VC_STATE_HH__
 #define __GARNET_OUT_VC_STATE_HH__
 
+#include <cassert>
 #include <cstdint>
+#include <vector>
+
+#include "Arena.hh"
+#include "BitMask.hh"
 #include "CommonTypes.hh"
 
 namespace garnet
 {
 
-class GarnetNetwork;
+class CheckpointIn;
+class CheckpointOut;
 
+// State of the VCs at the far end of one output port (the input VCs of
+// the downstream router or NI): credit counts in a packed array, plus
+// idle-VC and has-credit bitmasks kept up to date on every credit and
+// allocation, so that finding a free VC or checking for credit is a bit
+// operation.  A VC is either IDLE_ or ACTIVE_; state changes and queries
+// happen in the current cycle of the owning component, so states need no
+// timestamp.
 class OutVcState
 {
   public:
-    OutVcState(int id, GarnetNetwork *network_ptr, uint32_t consumerVcs);
-
-    int get_credit_count()          { return m_credit_count; }
-    inline bool has_credit()       { return (m_credit_count > 0); }
-    void increment_credit();
-    void decrement_credit();
+    OutVcState() {}
+    // With an arena (a router's), the per-VC arrays are carved from it.
+    OutVcState(int num_vcs, int vcs_per_vnet, Arena* arena = nullptr);
 
-    inline bool
-    isInState(VC_state_type state, uint64_t request_time)
-    {
-        return ((m_vc_state == state) && (request_time >= m_time) );
-    }
-    inline void
-    setState(VC_state_type state, uint64_t time)
+    int get_credit_count(int vc) const { return m_credit_count[vc]; }
+    // Credits across all VCs when none are in use.
+    int
+    get_total_credits() const
     {
-        m_vc_state = state;
-        m_time = time;
+        return m_max_credit_count * (int)m_credit_count.size();
     }
+    bool has_credit(int vc) const      { return m_has_credit.test(vc); }
+    void increment_credit(int vc);
+    void decrement_credit(int vc);
+
+    bool is_idle(int vc) const   { return m_idle.test(vc); }
+    bool is_active(int vc) const { return !m_idle.test(vc); }
+    void set_idle(int vc)        { m_idle.set(vc); }
+    void set_active(int vc)      { m_idle.reset(vc); }
+
+    // First idle VC of `vnet` in round-robin order from VC offset `start`
+    // within the vnet, or -1.
+    int find_idle(int vnet, int start = 0) const;
+
+    // VCs with at least one credit.
+    const BitMask& credit_mask() const { return m_has_credit; }
+
+    void saveState(CheckpointOut& cp) const;
+    void loadState(CheckpointIn& cp);
 
   private:
-    int m_id ;
-    uint64_t m_time;
-    VC_state_type m_vc_state;
-    int m_credit_count;
-    int m_max_credit_count;
+    int m_vcs_per_vnet = 1;
+    int m_max_credit_count = 1;
+    std::vector<int, ArenaAllocator<int>> m_credit_count;
+    BitMask m_idle;
+    BitMask m_has_credit;
 };
 
+inline void
+OutVcState::increment_credit(int vc)
+{
+    m_credit_count[vc]++;
+    assert(m_credit_count[vc] <= m_max_credit_count);
+    m_has_credit.set(vc);
+}
+
+inline void
+OutVcState::decrement_credit(int vc)
+{
+    m_credit_count[vc]--;
+    assert(m_credit_count[vc] >= 0);
+    if (m_credit_count[vc] == 0) m_has_credit.reset(vc);
+}
+
 } // namespace garnet
 
 #endif //__GARNET_OUT_VC_STATE_HH__
@@ -45,13 +45,13 @@ namespace garnet
 OutputUnit::OutputUnit(int id, PortDirection direction, Router *router,
   uint32_t consumerVcs)
   : m_router(router), m_id(id), m_direction(direction),
-    m_vc_per_vnet(consumerVcs)
+    m_vc_per_vnet(consumerVcs),
+    outVcState(consumerVcs * m_router->get_num_vnets(), consumerVcs,
+               &m_router->getArena())
 {
-    const int m_num_vcs = consumerVcs * m_router->get_num_vnets();
-    outVcState.reserve(m_num_vcs);
-    for (int i = 0; i < m_num_vcs; i++) {
-        outVcState.emplace_back(i, m_router->get_net_ptr(), consumerVcs);
-    }
+    set_kind(OUTPUT_UNIT);
+    // Every flit waiting for the link holds one of the consumer's credits.
+    outBuffer.setMaxSize(outVcState.get_total_credits());
 }
 
 // --- ADD THIS ENTIRE FUNCTION ---
@@ -68,13 +68,13 @@ OutputUnit::~OutputUnit()
 void
 OutputUnit::decrement_credit(int out_vc)
 {
-    outVcState[out_vc].decrement_credit();
+    outVcState.decrement_credit(out_vc);
 }
 
 void
 OutputUnit::increment_credit(int out_vc)
 {
-    outVcState[out_vc].increment_credit();
+    outVcState.increment_credit(out_vc);
 }
 
 // Check if the output VC (i.e., input VC at next router)
@@ -83,11 +83,7 @@ OutputUnit::increment_credit(int out_vc)
 bool
 OutputUnit::has_credit(int out_vc)
 {
-    uint64_t current_time = m_router->get_net_ptr()->getEventQueue()->get_current_time();
-    if (!outVcState[out_vc].isInState(ACTIVE_, current_time)) {
-        return false;
-    }
-    return outVcState[out_vc].has_credit();
+    return outVcState.is_active(out_vc) && outVcState.has_credit(out_vc);
 }
 
 
@@ -95,29 +91,16 @@ OutputUnit::has_credit(int out_vc)
 bool
 OutputUnit::has_free_vc(int vnet)
 {
-    int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
-        if (is_vc_idle(vc, m_router->get_net_ptr()->getEventQueue()->get_current_time()))
-            return true;
-    }
-
-    return false;
+    return outVcState.find_idle(vnet) != -1;
 }
 
 // Assign a free output VC to the winner of Switch Allocation
 int
 OutputUnit::select_free_vc(int vnet)
 {
-    int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
-        uint64_t current_time = m_router->get_net_ptr()->getEventQueue()->get_current_time();
-        if (is_vc_idle(vc, current_time)) {
-            outVcState[vc].setState(ACTIVE_, current_time);
-            return vc;
-        }
-    }
-
-    return -1;
+    int vc = outVcState.find_idle(vnet);
+    if (vc != -1) outVcState.set_active(vc);
+    return vc;
 }
 
 /*
@@ -137,7 +120,7 @@ OutputUnit::wakeup()
         increment_credit(t_credit->get_vc());
 
         if (t_credit->is_free_signal())
-            set_vc_state(IDLE_, t_credit->get_vc(), current_time);
+            set_vc_state(IDLE_, t_credit->get_vc());
 
         delete t_credit;
 
@@ -171,11 +154,27 @@ OutputUnit::insert_flit(flit *t_flit)
     if (t_flit->get_trace()) {
         uint64_t current_time = m_router->get_net_ptr()->getEventQueue()->get_current_time();
         std::cout << "TRACE: Packet " << t_flit->getPacketID() << " (Flit " << t_flit->get_id() << ") DEPARTING from Router " << m_router->get_id() 
-                  << " (" << m_router->get_x() << "," << m_router->get_y() << "," << m_router->get_z() << ") via port " << m_direction 
+                  << " (" << m_router->get_x() << "," << m_router->get_y() << "," << m_router->get_z() << ") via port " << portDirectionName(m_direction) 
                   << " at time " << current_time << std::endl;
     }
     outBuffer.insert(t_flit);
     m_out_link->scheduleEvent(1);
 }
 
+void
+OutputUnit::saveState(CheckpointOut& cp) const
+{
+    GarnetSimObject::saveState(cp);
+    outBuffer.saveState(cp);
+    outVcState.saveState(cp);
+}
+
+void
+OutputUnit::loadState(CheckpointIn& cp)
+{
+    GarnetSimObject::loadState(cp);
+    outBuffer.loadState(cp);
+    outVcState.loadState(cp);
+}
+
 } // namespace garnet
@@ -55,9 +55,12 @@ class OutputUnit : public GarnetSimObject
     ~OutputUnit();
     void set_out_link(NetworkLink *link);
     void set_credit_link(CreditLink *credit_link);
-    void wakeup();
+    void wakeup() final;
     flitBuffer* getOutQueue();
     void print(std::ostream& out) const {};
+
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp) override;
     void decrement_credit(int out_vc);
     void increment_credit(int out_vc);
     bool has_credit(int out_vc);
@@ -69,25 +72,34 @@ class OutputUnit : public GarnetSimObject
     int
     get_credit_count(int vc)
     {
-        return outVcState[vc].get_credit_count();
+        return outVcState.get_credit_count(vc);
     }
 
+    // Flits the consumer can buffer for this port.
+    int get_total_credits() const { return outVcState.get_total_credits(); }
+
     inline int
     get_outlink_id()
     {
         return m_out_link->get_id();
     }
 
+    NetworkLink* get_out_link() { return m_out_link; }
+
     inline void
-    set_vc_state(VC_state_type state, int vc, uint64_t curTime)
+    set_vc_state(VC_state_type state, int vc)
     {
-      outVcState[vc].setState(state, curTime);
+        assert(state == IDLE_ || state == ACTIVE_);
+        if (state == IDLE_)
+            outVcState.set_idle(vc);
+        else
+            outVcState.set_active(vc);
     }
 
     inline bool
-    is_vc_idle(int vc, uint64_t curTime)
+    is_vc_idle(int vc)
     {
-        return (outVcState[vc].isInState(IDLE_, curTime));
+        return outVcState.is_idle(vc);
     }
 
     void insert_flit(flit *t_flit);
@@ -113,7 +125,7 @@ class OutputUnit : public GarnetSimObject
     // This is for the network link to consume
     flitBuffer outBuffer;
     // vc state of downstream router
-    std::vector<OutVcState> outVcState;
+    OutVcState outVcState;
 };
 
 } // namespace garnet
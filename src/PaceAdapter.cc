@@ -29,6 +29,9 @@ PaceTrafficGenerator::PaceTrafficGenerator(int id, GarnetNetwork* net,
       m_mshr_stall_cycles(0),
       m_is_bursting(false), m_prob_stay_on(0.0), m_prob_stay_off(1.0),
       m_last_phase_idx(-1),
+      m_next_injection(static_cast<uint64_t>(-1)), m_deferred(0),
+      m_last_busy_cycle(static_cast<uint64_t>(-1)), m_burst_left(0),
+      m_next_drain(static_cast<uint64_t>(-1)), m_drain_phase(-1),
       m_stalled_flit(nullptr),
       m_last_injection_cycle(static_cast<uint64_t>(-1)),
       m_last_drain_cycle(static_cast<uint64_t>(-1)),
@@ -37,7 +40,7 @@ PaceTrafficGenerator::PaceTrafficGenerator(int id, GarnetNetwork* net,
       m_trace(false),
       m_dist(0.0, 1.0)
 {
-    m_rng.seed(seed + id);
+    seed_streams(seed);
     m_received_per_vnet.resize(3, 0);
     m_latency_per_vnet.resize(3, 0);
 }
@@ -45,10 +48,7 @@ PaceTrafficGenerator::PaceTrafficGenerator(int id, GarnetNetwork* net,
 PaceTrafficGenerator::~PaceTrafficGenerator()
 {
     if (m_stalled_flit) delete m_stalled_flit;
-    while (!m_flit_queue.empty()) {
-        delete m_flit_queue.front();
-        m_flit_queue.pop();
-    }
+    while (!m_flit_queue.isEmpty()) delete m_flit_queue.getTopFlit();
     // ResponseJobs hold no heap resources.
 }
 
@@ -57,6 +57,14 @@ uint64_t PaceTrafficGenerator::current_time() const
     return m_net_ptr->getEventQueue()->get_current_time();
 }
 
+void PaceTrafficGenerator::seed_streams(int seed)
+{
+    m_injection_rng.seed(seed, m_id, INJECTION_STREAM);
+    m_packet_rng.seed(seed, m_id, PACKET_STREAM);
+    m_drain_rng.seed(seed, m_id, DRAIN_STREAM);
+    m_response_rng.seed(seed, m_id, RESPONSE_STREAM);
+}
+
 // Build and enqueue all flits of a packet into m_flit_queue.
 void PaceTrafficGenerator::generate_packet(int dest_ni, int dest_router,
                                            int vnet, int num_flits,
@@ -65,20 +73,19 @@ void PaceTrafficGenerator::generate_packet(int dest_ni, int dest_router,
     int packet_id = m_net_ptr->getNextPacketID();
     uint32_t flit_width = m_net_ptr->getNiFlitSize();
 
-    RouteInfo route;
-    route.src_ni     = m_id;
-    route.src_router = m_ni->get_router_id(vnet);
-    route.dest_ni    = dest_ni;
-    route.dest_router = dest_router;
-    route.vnet       = vnet;
-    route.net_dest.add(dest_ni);
-
-    for (int i = 0; i < num_flits; ++i) {
-        flit* fl = new flit(packet_id, i, 0, vnet, route,
-                            num_flits, nullptr, 0, flit_width, time);
-        fl->set_trace(m_trace);
-        m_flit_queue.push(fl);
-    }
+    PacketHeader* pkt = new PacketHeader;
+    pkt->route.src_ni     = m_id;
+    pkt->route.src_router = m_ni->get_router_id(vnet);
+    pkt->route.dest_ni    = dest_ni;
+    pkt->route.dest_router = dest_router;
+    pkt->route.vnet       = vnet;
+    pkt->packet_id     = packet_id;
+    pkt->creation_time = time;
+    pkt->trace         = m_trace;
+
+    for (int i = 0; i < num_flits; ++i)
+        m_flit_queue.insert(new flit(pkt, i, 0, vnet, num_flits, flit_width,
+                                   time));
 }
 
 void PaceTrafficGenerator::update_burst_parameters(double lambda, double variance)
@@ -110,28 +117,27 @@ flit* PaceTrafficGenerator::send_flit()
     // Step 2 Hack: drain MSHRs (pending requests)
     if (m_pending_requests > 0 && t != m_last_drain_cycle) {
         m_last_drain_cycle = t;
-        // Drain probability: 1.0 / avg_lat. 
-        // We use current phase's avg_packet_latency.
-        double avg_lat = m_adapter->get_avg_latency();
-        if (avg_lat > 0.0) {
-            if (m_dist(m_rng) < (1.0 / avg_lat)) {
-                --m_pending_requests;
-                m_adapter->record_mshr_sample(m_id, m_pending_requests);
-            }
+        if (m_drain_phase != m_adapter->current_phase_idx())
+            schedule_drain(t);
+        if (t >= m_next_drain) {
+            --m_pending_requests;
+            m_adapter->record_mshr_sample(m_id, m_pending_requests);
+            schedule_drain(t + 1);
         }
     }
 
     // (A) Return previously stalled flit (already generated, just retrying).
     if (m_stalled_flit) {
+        if (t != m_last_injection_cycle) skip_decision(t);
         flit* fl = m_stalled_flit;
         m_stalled_flit = nullptr;
         return fl;
     }
 
     // (B) Continue sending flits of the current in-progress packet.
-    if (!m_flit_queue.empty()) {
-        flit* fl = m_flit_queue.front();
-        m_flit_queue.pop();
+    if (!m_flit_queue.isEmpty()) {
+        if (t != m_last_injection_cycle) skip_decision(t);
+        flit* fl = m_flit_queue.getTopFlit();
         fl->set_enqueue_time(t);
         return fl;
     }
@@ -140,16 +146,21 @@ flit* PaceTrafficGenerator::send_flit()
     if (t == m_last_injection_cycle) return nullptr;
     m_last_injection_cycle = t;
     ++m_injection_attempts;
+    // Busy earlier this cycle after all.
+    if (m_last_busy_cycle == t) {
+        --m_deferred;
+        m_last_busy_cycle = static_cast<uint64_t>(-1);
+    }
 
     // Priority 1: pending responses (directory role).
     if (!m_pending_responses.empty()) {
+        skip_decision(t);
         ResponseJob job = m_pending_responses.front();
         m_pending_responses.pop();
         generate_packet(job.dest_ni, job.dest_router, /*vnet=*/1,
                         job.num_flits, t);
         ++m_injected_packets;
-        flit* fl = m_flit_queue.front();
-        m_flit_queue.pop();
+        flit* fl = m_flit_queue.getTopFlit();
         fl->set_enqueue_time(t);
         return fl;
     }
@@ -168,33 +179,31 @@ flit* PaceTrafficGenerator::send_flit()
         update_burst_parameters(ph_lambda, ph_variance);
         m_mshr_limit = m_adapter->get_mshr_limit();
         m_last_phase_idx = current_ph;
+        // Whatever was drawn ahead used the old parameters.
+        m_burst_left = 0;
+        schedule_next_injection(t);
+    } else {
+        m_next_injection = after(m_next_injection, m_deferred);
+        m_deferred = 0;
     }
 
-    // Step 3: Probabilistic injection check with Burst Model
-    double lambda = m_adapter->get_injection_prob(m_id);
-    double variance = m_adapter->get_variance();
-    double Cv2 = variance * (lambda * lambda);
+    // Step 3: Probabilistic injection check with Burst Model, drawn ahead
+    // by schedule_next_injection().
+    if (t < m_next_injection) return nullptr;
 
-    bool would_inject = false;
+    double lambda = m_adapter->get_injection_prob(m_id);
+    double Cv2 = m_adapter->get_variance() * (lambda * lambda);
     // --burst-model=off forces smooth Poisson regardless of variance
-    bool use_burst = (Cv2 > 1.0) && !m_adapter->no_burst();
-    if (!use_burst) {
-        // Smooth traffic: standard uniform random (Poisson)
-        if (lambda > 0.0 && m_dist(m_rng) < lambda) would_inject = true;
-    } else {
-        // Bursty traffic: ON/OFF Markov state machine
-        if (m_is_bursting) {
-            would_inject = true; // ON state
-            // Transition check for NEXT cycle
-            if (m_dist(m_rng) > m_prob_stay_on) m_is_bursting = false;
-        } else {
-            // Transition check for NEXT cycle
-            if (m_dist(m_rng) > m_prob_stay_off) m_is_bursting = true;
-            would_inject = false; // OFF state
-        }
+    if (Cv2 > 1.0 && !m_adapter->no_burst()) {
+        // ON state: inject at every decision; the length of the ON period
+        // is drawn at its first one.
+        m_is_bursting = true;
+        if (m_burst_left == 0)
+            m_burst_left = after(1, geometric_gap(1.0 - m_prob_stay_on,
+                                                  m_dist(m_injection_rng)));
+        if (--m_burst_left == 0) m_is_bursting = false;
     }
-
-    if (!would_inject) return nullptr;
+    schedule_next_injection(t + 1);
 
     // Step 2: Hard MSHR cap (skipped when --pace-no-mshr is active).
     if (!m_adapter->no_mshr() && m_pending_requests >= m_mshr_limit) {
@@ -207,7 +216,7 @@ flit* PaceTrafficGenerator::send_flit()
     if (!should_inject) return nullptr;
 
     // Virtual network selection.
-    int vnet = m_adapter->select_vnet(m_rng, m_dist);
+    int vnet = m_adapter->select_vnet(m_packet_rng, m_dist);
 
     // Packet size: vnet0 (requests) and vnet2 (writeback notifications) are
     // always 1-flit control messages.  Only vnet1 (responses) carries data
@@ -215,7 +224,7 @@ flit* PaceTrafficGenerator::send_flit()
     int num_flits;
     if (vnet == 1) {
         double data_frac = m_adapter->get_data_frac();
-        num_flits = (m_dist(m_rng) < data_frac)
+        num_flits = (m_dist(m_packet_rng) < data_frac)
                     ? m_adapter->data_packet_flits()
                     : m_adapter->ctrl_packet_flits();
     } else {
@@ -226,7 +235,7 @@ flit* PaceTrafficGenerator::send_flit()
     int dest_ni, dest_router;
     if (vnet == 0 || vnet == 2) {
         // Request or writeback -> goes to a directory.
-        int dir = m_adapter->select_dest_dir(m_rng, m_dist);
+        int dir = m_adapter->select_dest_dir(m_packet_rng, m_dist);
         dest_router = m_adapter->dir_to_router(dir);
         dest_ni     = m_adapter->dir_to_ni(dir); // first NI on that router
     } else {
@@ -236,7 +245,7 @@ flit* PaceTrafficGenerator::send_flit()
         int num_nodes = m_adapter->num_nodes();
         if (num_nodes <= 1) return nullptr;  // no other core to send to
         std::uniform_int_distribution<int> core_dist(0, num_nodes - 2);
-        int r = core_dist(m_rng);
+        int r = core_dist(m_packet_rng);
         dest_ni     = (r >= m_id) ? r + 1 : r;
         dest_router = m_net_ptr->get_router_id(dest_ni, vnet);
     }
@@ -251,17 +260,73 @@ flit* PaceTrafficGenerator::send_flit()
     }
 
     // MSHR: track all successful core injections (Step 2)
+    if (m_pending_requests == 0) schedule_drain(t + 1);
     ++m_pending_requests;
     if (m_pending_requests > m_max_mshr_count)
         m_max_mshr_count = m_pending_requests;
     m_adapter->record_mshr_sample(m_id, m_pending_requests);
 
-    flit* fl = m_flit_queue.front();
-    m_flit_queue.pop();
+    flit* fl = m_flit_queue.getTopFlit();
     fl->set_enqueue_time(t);
     return fl;
 }
 
+// Injection decisions are Bernoulli(lambda) trials, or follow the ON/OFF
+// chain of the burst model: an OFF period ends after each of its decisions
+// with probability 1 - stay_off, and the ON period after it injects at
+// every decision and ends after each with probability 1 - stay_on.  Either
+// way the number of decisions to the next injection is geometric, so it is
+// drawn here instead of once per decision.
+void PaceTrafficGenerator::schedule_next_injection(uint64_t from)
+{
+    m_deferred = 0;
+    double lambda = m_adapter->get_injection_prob(m_id);
+    double Cv2 = m_adapter->get_variance() * (lambda * lambda);
+    if (Cv2 <= 1.0 || m_adapter->no_burst())
+        m_next_injection =
+            after(from, geometric_gap(lambda, m_dist(m_injection_rng)));
+    else if (m_is_bursting)
+        m_next_injection = from;
+    else
+        m_next_injection = after(from, after(1, geometric_gap(
+            1.0 - m_prob_stay_off, m_dist(m_injection_rng))));
+}
+
+void PaceTrafficGenerator::skip_decision(uint64_t t)
+{
+    if (!m_is_core || t == m_last_busy_cycle) return;
+    m_last_busy_cycle = t;
+    ++m_deferred;
+}
+
+// Drain probability: 1.0 / avg_lat of the current phase, per cycle.
+void PaceTrafficGenerator::schedule_drain(uint64_t from)
+{
+    double avg_lat = m_adapter->get_avg_latency();
+    m_next_drain = avg_lat > 0.0
+        ? after(from, geometric_gap(1.0 / avg_lat, m_dist(m_drain_rng)))
+        : static_cast<uint64_t>(-1);
+    m_drain_phase = m_adapter->current_phase_idx();
+}
+
+uint64_t PaceTrafficGenerator::get_next_injection_time() const
+{
+    // Flits and responses go out at once; otherwise wake for the next
+    // injection or drain, or at once to draw them again for a new phase.
+    uint64_t now = current_time();
+    if (m_stalled_flit || !m_flit_queue.isEmpty() ||
+        !m_pending_responses.empty())
+        return now;
+    int phase = m_adapter->current_phase_idx();
+    uint64_t next = static_cast<uint64_t>(-1);
+    if (m_is_core && !m_adapter->is_done())
+        next = phase != m_last_phase_idx
+               ? now : after(m_next_injection, m_deferred);
+    if (m_pending_requests > 0)
+        next = std::min(next, phase != m_drain_phase ? now : m_next_drain);
+    return next;
+}
+
 void PaceTrafficGenerator::receive_flit(flit* flt)
 {
     uint64_t t = current_time();
@@ -295,7 +360,8 @@ void PaceTrafficGenerator::receive_flit(flit* flt)
                 resp_flits = 1;
             } else {
                 // vnet 0 request: correlated response sizing.
-                resp_flits = m_adapter->select_response_size(m_rng, m_dist);
+                resp_flits = m_adapter->select_response_size(m_response_rng,
+                                                             m_dist);
             }
             ResponseJob job;
             job.dest_ni       = flt->get_route().src_ni;
@@ -309,6 +375,86 @@ void PaceTrafficGenerator::receive_flit(flit* flt)
     delete flt;
 }
 
+void PaceTrafficGenerator::saveState(CheckpointOut& cp) const
+{
+    cp.put(m_pending_requests);
+    cp.put(m_max_mshr_count);
+    cp.put(m_mshr_stall_cycles);
+    cp.put(m_is_bursting);
+    cp.put(m_prob_stay_on);
+    cp.put(m_prob_stay_off);
+    cp.put(m_last_phase_idx);
+    cp.put(m_next_injection);
+    cp.put(m_deferred);
+    cp.put(m_last_busy_cycle);
+    cp.put(m_burst_left);
+    cp.put(m_next_drain);
+    cp.put(m_drain_phase);
+
+    m_flit_queue.saveState(cp);
+    cp.putFlit(m_stalled_flit);
+    std::queue<ResponseJob> responses = m_pending_responses;
+    cp.put((uint64_t)responses.size());
+    for (; !responses.empty(); responses.pop()) cp.put(responses.front());
+
+    cp.put(m_last_injection_cycle);
+    cp.put(m_last_drain_cycle);
+    cp.put(m_total_latency);
+    cp.put(m_received_packets);
+    cp.put(m_injected_packets);
+    cp.put(m_injection_attempts);
+    cp.put(m_received_per_vnet);
+    cp.put(m_latency_per_vnet);
+    cp.put(m_trace);
+    cp.put(m_injection_rng);
+    cp.put(m_packet_rng);
+    cp.put(m_drain_rng);
+    cp.put(m_response_rng);
+}
+
+void PaceTrafficGenerator::loadState(CheckpointIn& cp)
+{
+    cp.get(m_pending_requests);
+    cp.get(m_max_mshr_count);
+    cp.get(m_mshr_stall_cycles);
+    cp.get(m_is_bursting);
+    cp.get(m_prob_stay_on);
+    cp.get(m_prob_stay_off);
+    cp.get(m_last_phase_idx);
+    cp.get(m_next_injection);
+    cp.get(m_deferred);
+    cp.get(m_last_busy_cycle);
+    cp.get(m_burst_left);
+    cp.get(m_next_drain);
+    cp.get(m_drain_phase);
+
+    m_flit_queue.loadState(cp);
+    delete m_stalled_flit;
+    m_stalled_flit = cp.getFlit();
+    m_pending_responses = std::queue<ResponseJob>();
+    uint64_t size = 0;
+    cp.get(size);
+    for (uint64_t i = 0; i < size && cp.ok(); ++i) {
+        ResponseJob job;
+        cp.get(job);
+        m_pending_responses.push(job);
+    }
+
+    cp.get(m_last_injection_cycle);
+    cp.get(m_last_drain_cycle);
+    cp.get(m_total_latency);
+    cp.get(m_received_packets);
+    cp.get(m_injected_packets);
+    cp.get(m_injection_attempts);
+    cp.get(m_received_per_vnet);
+    cp.get(m_latency_per_vnet);
+    cp.get(m_trace);
+    cp.get(m_injection_rng);
+    cp.get(m_packet_rng);
+    cp.get(m_drain_rng);
+    cp.get(m_response_rng);
+}
+
 // ============================================================
 // PaceAdapter — implementation
 // ============================================================
@@ -325,7 +471,8 @@ PaceAdapter::PaceAdapter(const std::string& profile_path,
       m_target_packets_per_node(packets_per_node),
       m_temporal_floor(temporal_floor), m_diameter(10)
 {
-    m_profile = PaceProfile::load(profile_path);
+    // The adapter rescales and remaps its phases, so it works on a copy.
+    m_profile = *PaceProfile::shared(profile_path);
 
     // --pace-no-phases: collapse all phases into a single aggregate phase.
     if (m_ablation.no_phases && m_profile.phases.size() > 1) {
@@ -409,13 +556,6 @@ PaceAdapter::PaceAdapter(const std::string& profile_path,
         agg.vnet2_prob = 1.0 - agg.vnet0_prob - agg.vnet1_prob;
         if (agg.vnet2_prob < 0.0) agg.vnet2_prob = 0.0;
 
-        // Derive cumulative dir_fractions.
-        double cum = 0.0;
-        for (const auto& kv : agg.dir_fractions) {
-            cum += kv.second;
-            agg.dir_cumulative.push_back({kv.first, cum});
-        }
-
         // Derive response_data_prob.
         int64_t v0f = vpkt(0);
         int64_t v2f = vpkt(2) * m_profile.model.data_packet_flits;
@@ -423,6 +563,7 @@ PaceAdapter::PaceAdapter(const std::string& profile_path,
         int64_t v1p = vpkt(1) > 0 ? vpkt(1) : 1;
         double data_resp = (double)(v1f - v1p) / (4.0 * v1p);
         agg.response_data_prob = std::max(0.0, std::min(1.0, data_resp));
+        agg.compile();
 
         m_profile.phases    = {agg};
         m_profile.num_phases = 1;
@@ -468,6 +609,7 @@ void PaceAdapter::init(const std::vector<NetworkInterface*>& nis,
         m_concentration = (num_physical_routers > 0 && num_nis > num_physical_routers)
                           ? num_nis / num_physical_routers : 1;
     }
+    build_dir_table();
 
     // Build reverse map: router_id -> dir_id (for quick lookup).
     std::map<int, int> router_to_dir;
@@ -603,6 +745,47 @@ bool PaceAdapter::tick(uint64_t /*current_cycle*/)
     return true;
 }
 
+void PaceAdapter::saveState(CheckpointOut& cp) const
+{
+    cp.put(m_current_phase);
+    cp.put(m_cycles_in_phase);
+    cp.put(m_packets_in_current_phase);
+    cp.put(m_done);
+    cp.put(m_lat_hist);
+    cp.put((uint64_t)m_phase_metrics.size());
+    for (const auto& pm : m_phase_metrics) cp.put(pm);
+    cp.put(m_total_latency_sum);
+    cp.put(m_total_packets_received);
+    cp.put(m_total_flits_received);
+    cp.put(m_mshr_sum);
+    cp.put(m_mshr_sample_count);
+    cp.put(m_max_mshr_per_node);
+}
+
+void PaceAdapter::loadState(CheckpointIn& cp)
+{
+    cp.get(m_current_phase);
+    cp.get(m_cycles_in_phase);
+    cp.get(m_packets_in_current_phase);
+    cp.get(m_done);
+    cp.get(m_lat_hist);
+    uint64_t phases = 0;
+    cp.get(phases);
+    if (phases != m_phase_metrics.size()) {
+        cp.fail("checkpoint has " + std::to_string(phases) +
+                " PACE phases, the profile " +
+                std::to_string(m_phase_metrics.size()));
+        return;
+    }
+    for (auto& pm : m_phase_metrics) cp.get(pm);
+    cp.get(m_total_latency_sum);
+    cp.get(m_total_packets_received);
+    cp.get(m_total_flits_received);
+    cp.get(m_mshr_sum);
+    cp.get(m_mshr_sample_count);
+    cp.get(m_max_mshr_per_node);
+}
+
 uint64_t PaceAdapter::total_network_cycles() const
 {
     // network_cycles is guaranteed non-zero here: PaceProfile::load() falls
@@ -622,10 +805,9 @@ double PaceAdapter::get_injection_prob(int ni_id) const
     // per_router_prob is keyed by physical router_id.
     // For CMesh (concentration > 1): ni_id / concentration = router_id,
     // and the per-NI rate = per-router rate / concentration.
-    int router_id = ni_id / m_concentration;
-    auto it = ph.per_router_prob.find(router_id);
-    if (it == ph.per_router_prob.end()) return 0.0;
-    return it->second / m_concentration;
+    size_t router_id = (size_t)(ni_id / m_concentration);
+    if (router_id >= ph.router_prob.size()) return 0.0;
+    return ph.router_prob[router_id] / m_concentration;
 }
 
 double PaceAdapter::get_data_frac() const
@@ -633,17 +815,13 @@ double PaceAdapter::get_data_frac() const
     return current_phase().data_pct / 100.0;
 }
 
-int PaceAdapter::select_vnet(std::mt19937& rng,
+int PaceAdapter::select_vnet(CounterRng& rng,
                               std::uniform_real_distribution<double>& dist) const
 {
-    const PacePhase& ph = current_phase();
-    double r = dist(rng);
-    if (r < ph.vnet0_prob) return 0;
-    if (r < ph.vnet0_prob + ph.vnet1_prob) return 1;
-    return 2;
+    return (int)current_phase().vnet_alias.sample(dist(rng));
 }
 
-int PaceAdapter::select_dest_dir(std::mt19937& rng,
+int PaceAdapter::select_dest_dir(CounterRng& rng,
                                   std::uniform_real_distribution<double>& dist) const
 {
     // --pace-no-weighted-dest: uniform random directory selection.
@@ -652,15 +830,17 @@ int PaceAdapter::select_dest_dir(std::mt19937& rng,
         return uid(rng);
     }
     const PacePhase& ph = current_phase();
-    double r = dist(rng);
-    for (const auto& entry : ph.dir_cumulative) {
-        if (r < entry.second) return entry.first;
-    }
-    // Fallback: return last dir.
-    return ph.dir_cumulative.back().first;
+    return ph.dir_ids[ph.dir_alias.sample(dist(rng))];
 }
 
 int PaceAdapter::dir_to_router(int dir_id) const
+{
+    if (dir_id >= 0 && (size_t)dir_id < m_dir_router.size())
+        return m_dir_router[dir_id];
+    return lookup_dir_router(dir_id);
+}
+
+int PaceAdapter::lookup_dir_router(int dir_id) const
 {
     // --pace-no-remap: identity mapping (dir d -> router d, modulo num_physical_routers).
     if (m_ablation.no_remap) {
@@ -682,7 +862,18 @@ int PaceAdapter::dir_to_ni(int dir_id) const
     return dir_to_router(dir_id) * m_concentration;
 }
 
-int PaceAdapter::select_response_size(std::mt19937& rng,
+void PaceAdapter::build_dir_table()
+{
+    // Every dir_id a phase can pick: 0..num_dirs-1 and the dir_fractions keys.
+    int max_dir = m_profile.num_dirs - 1;
+    for (const auto& ph : m_profile.phases)
+        if (!ph.dir_ids.empty()) max_dir = std::max(max_dir, ph.dir_ids.back());
+    m_dir_router.clear();
+    for (int d = 0; d <= max_dir; ++d)
+        m_dir_router.push_back(lookup_dir_router(d));
+}
+
+int PaceAdapter::select_response_size(CounterRng& rng,
                                        std::uniform_real_distribution<double>& dist) const
 {
     // --pace-no-corr-response: always return fixed data packet size (5 flits).
@@ -696,6 +887,7 @@ int PaceAdapter::select_response_size(std::mt19937& rng,
 void PaceAdapter::record_packet_received(uint64_t latency, int phase_idx,
                                           int /*vnet*/, int num_flits)
 {
+    std::lock_guard<std::mutex> lock(m_record_mutex);
     m_lat_hist.insert(latency);
     m_total_latency_sum += latency;
     ++m_total_packets_received;
@@ -742,13 +934,15 @@ void PaceAdapter::dump_results_with_multiplier(
         const std::string& path,
         const std::vector<NetworkLink*>& links,
         uint64_t total_cycles,
-        double lambda_multiplier) const
+        double lambda_multiplier,
+        std::string* json) const
 {
-    std::ofstream f(path);
-    if (!f.is_open()) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
         std::cerr << "PACE: cannot write results to " << path << "\n";
         return;
     }
+    std::ostringstream f;
 
     double avg_lat = m_total_packets_received > 0
                      ? (double)m_total_latency_sum / m_total_packets_received
@@ -996,7 +1190,9 @@ void PaceAdapter::dump_results_with_multiplier(
     f << "  ]\n";
 
     f << "}\n";
-    f.close();
+    out << f.str();
+    out.close();
+    if (json) *json = f.str();
 
     std::cout << "PACE: results written to " << path << "\n"
               << "  method=" << method
@@ -1018,12 +1214,14 @@ void PaceAdapter::scale_lambda(double multiplier)
         ph.lambda *= multiplier;
         for (auto& kv : ph.per_router_prob)
             kv.second *= multiplier;
+        ph.compile();
     }
 }
 
 void PaceAdapter::set_directory_remapping(const std::map<int,int>& remap)
 {
     m_profile.directory_remapping = remap;
+    if (!m_dir_router.empty()) build_dir_table();
     std::cout << "PACE: directory remapping overridden via --pace-dir-routers:\n";
     for (const auto& kv : remap)
         std::cout << "  dir " << kv.first << " -> router " << kv.second << "\n";
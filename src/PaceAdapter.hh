@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 #include <cstdint>
 
 #include "PaceProfile.hh"
@@ -84,17 +85,19 @@ public:
     // data_pct / 100 for the current phase.
     double get_data_frac() const;
 
-    // Weighted vnet selection using current phase's vnet_packets.
-    // Returns 0, 1, or 2.
-    int select_vnet(std::mt19937& rng,
+    // Weighted vnet selection using current phase's vnet_packets (one
+    // alias-table draw).  Returns 0, 1, or 2.
+    int select_vnet(CounterRng& rng,
                     std::uniform_real_distribution<double>& dist) const;
 
-    // Weighted directory selection using current phase's dir_fractions.
+    // Weighted directory selection using current phase's dir_fractions
+    // (one alias-table draw, whatever the number of directories).
     // Returns the dir_id.
-    int select_dest_dir(std::mt19937& rng,
+    int select_dest_dir(CounterRng& rng,
                         std::uniform_real_distribution<double>& dist) const;
 
-    // Map dir_id -> router_id in the current target topology.
+    // Map dir_id -> router_id in the current target topology.  A table
+    // lookup once init() has run.
     int dir_to_router(int dir_id) const;
 
     // Map dir_id -> NI id of the directory NI at that router.
@@ -115,10 +118,12 @@ public:
     int num_nodes() const { return m_num_routers; }
 
     // Select response size (1 or data_packet_flits) using correlated sizing.
-    int select_response_size(std::mt19937& rng,
+    int select_response_size(CounterRng& rng,
                              std::uniform_real_distribution<double>& dist) const;
 
     // ---- Metric recording (called by TGs) ----
+    // record_packet_received() may be called from several SimKernel
+    // threads at once; record_mshr_sample() only touches node_id's entry.
 
     void record_packet_received(uint64_t latency, int phase_idx,
                                 int vnet, int num_flits);
@@ -134,16 +139,28 @@ public:
                       uint64_t total_cycles) const;
 
     // Same as dump_results but also records the lambda_multiplier in the JSON.
-    // Used by sweep mode.
+    // Used by sweep mode, which also takes a copy of the JSON text via `json`.
     void dump_results_with_multiplier(const std::string& path,
                                       const std::vector<NetworkLink*>& links,
                                       uint64_t total_cycles,
-                                      double lambda_multiplier) const;
+                                      double lambda_multiplier,
+                                      std::string* json = nullptr) const;
+
+    // Totals over all received packets (for sweep seed statistics).
+    const LatHist& get_lat_hist()           const { return m_lat_hist; }
+    uint64_t get_total_latency_sum()        const { return m_total_latency_sum; }
+    uint64_t get_total_packets_received()   const { return m_total_packets_received; }
+    uint64_t get_total_flits_received()     const { return m_total_flits_received; }
 
     // Scale all per_router_prob and lambda values by multiplier.
     // Used by sweep mode before each run.
     void scale_lambda(double multiplier);
 
+    // Checkpointing: phase position and global metrics.  The generators
+    // are saved with their NIs.
+    void saveState(CheckpointOut& cp) const;
+    void loadState(CheckpointIn& cp);
+
     // Override directory remapping from profile (call before init()).
     // remap[dir_id] = router_id in the target topology.
     void set_directory_remapping(const std::map<int,int>& remap);
@@ -162,6 +179,10 @@ private:
         return m_profile.phases[idx];
     }
 
+    // dir_to_router() without the table, and the table built from it.
+    int  lookup_dir_router(int dir_id) const;
+    void build_dir_table();
+
     PaceProfile    m_profile;
     int            m_current_phase;
     uint64_t       m_cycles_in_phase;
@@ -172,6 +193,7 @@ private:
     int                m_num_routers;    // set in init(); == num_cpus (node count for packet threshold)
     int                m_concentration; // NIs per physical router (1 = standard, >1 = CMesh)
     PaceAblationConfig m_ablation;
+    std::vector<int>   m_dir_router;    // dir_id -> router_id, built in init()
 
     int      m_target_packets_per_node;
     double   m_temporal_floor;
@@ -180,6 +202,7 @@ private:
     std::vector<PaceTrafficGenerator*> m_tgs;
 
     // ---- Global metrics ----
+    std::mutex                   m_record_mutex;  // serialises record_packet_received()
     LatHist                      m_lat_hist;  // from StandaloneStats.hh
     std::vector<PhaseMetrics>    m_phase_metrics;
     uint64_t m_total_latency_sum;
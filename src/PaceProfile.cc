@@ -0,0 +1,324 @@
+#include "PaceProfile.hh"
+
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace garnet {
+
+namespace {
+
+const char kImageMagic[8] = {'P', 'A', 'C', 'E', 'I', 'M', 'G', '\0'};
+// Bump whenever the layout written by save_image() changes.
+const uint32_t kImageVersion = 1;
+const uint32_t kByteOrderMark = 0x01020304;
+
+class ImageOut {
+public:
+    explicit ImageOut(const std::string& path)
+        : m_out(path, std::ios::binary | std::ios::trunc) {}
+
+    bool ok() const { return (bool)m_out; }
+
+    template <typename T>
+    void put(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "only raw values are stored as bytes");
+        m_out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    template <typename T>
+    void put(const std::vector<T>& values)
+    {
+        put((uint64_t)values.size());
+        for (const auto& value : values) put(value);
+    }
+    template <typename K, typename V>
+    void put(const std::map<K, V>& values)
+    {
+        put((uint64_t)values.size());
+        for (const auto& kv : values) {
+            put(kv.first);
+            put(kv.second);
+        }
+    }
+    void put(const std::string& text)
+    {
+        put((uint64_t)text.size());
+        m_out.write(text.data(), text.size());
+    }
+    void put(const AliasTable& table)
+    {
+        put((uint64_t)table.size());
+        for (const auto& column : table.columns()) {
+            put(column.prob);
+            put(column.alias);
+        }
+    }
+
+private:
+    std::ofstream m_out;
+};
+
+// Decodes an image from a byte range (the file's mapping in load_image())
+// into owned values; nothing refers back to the range afterwards.  Once a
+// read runs past the end every later one yields zeros and ok() is false.
+class ImageIn {
+public:
+    ImageIn(const char* begin, size_t size)
+        : m_next(begin), m_end(begin + size) {}
+
+    bool ok() const { return m_ok; }
+    bool at_end() const { return m_next == m_end; }
+
+    template <typename T>
+    void get(T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "only raw values are stored as bytes");
+        value = T();
+        if (take(sizeof(T))) std::memcpy(&value, m_next - sizeof(T), sizeof(T));
+    }
+    template <typename T>
+    void get(std::vector<T>& values)
+    {
+        uint64_t size = count(sizeof(T));
+        values.resize(size);
+        for (auto& value : values) get(value);
+    }
+    template <typename K, typename V>
+    void get(std::map<K, V>& values)
+    {
+        uint64_t size = count(sizeof(K) + sizeof(V));
+        values.clear();
+        for (uint64_t i = 0; i < size; ++i) {
+            K key;
+            get(key);
+            get(values[key]);
+        }
+    }
+    void get(std::string& text)
+    {
+        uint64_t size = count(1);
+        text.assign(m_next, size);
+        take(size);
+    }
+    void get(AliasTable& table)
+    {
+        uint64_t size = count(sizeof(double) + sizeof(uint32_t));
+        std::vector<AliasTable::Column> columns(size);
+        for (auto& column : columns) {
+            get(column.prob);
+            get(column.alias);
+        }
+        table.assign(std::move(columns));
+    }
+
+private:
+    bool take(size_t bytes)
+    {
+        if (!m_ok || (size_t)(m_end - m_next) < bytes) {
+            m_ok = false;
+            m_next = m_end;
+            return false;
+        }
+        m_next += bytes;
+        return true;
+    }
+    // A stored element count, 0 if the elements cannot all be there.
+    uint64_t count(size_t element_bytes)
+    {
+        uint64_t size = 0;
+        get(size);
+        if (size > (uint64_t)(m_end - m_next) / element_bytes) {
+            m_ok = false;
+            m_next = m_end;
+            return 0;
+        }
+        return size;
+    }
+
+    const char* m_next;
+    const char* m_end;
+    bool m_ok = true;
+};
+
+void save_phase(ImageOut& out, const PacePhase& ph)
+{
+    out.put(ph.phase_index);
+    out.put(ph.total_packets);
+    out.put(ph.total_flits);
+    out.put(ph.flits_per_packet);
+    out.put(ph.data_pct);
+    out.put(ph.ctrl_pct);
+    out.put(ph.sim_ticks);
+    out.put(ph.network_cycles);
+    out.put(ph.lambda);
+    out.put(ph.avg_packet_latency);
+    out.put(ph.variance);
+    out.put(ph.mshr_limit);
+    out.put(ph.vnet_packets);
+    out.put(ph.per_router_injection);
+    out.put(ph.dir_fractions);
+
+    out.put(ph.per_router_prob);
+    out.put(ph.vnet0_prob);
+    out.put(ph.vnet1_prob);
+    out.put(ph.vnet2_prob);
+    out.put(ph.response_data_prob);
+
+    out.put(ph.router_prob);
+    out.put(ph.vnet_alias);
+    out.put(ph.dir_ids);
+    out.put(ph.dir_alias);
+}
+
+void load_phase(ImageIn& in, PacePhase& ph)
+{
+    in.get(ph.phase_index);
+    in.get(ph.total_packets);
+    in.get(ph.total_flits);
+    in.get(ph.flits_per_packet);
+    in.get(ph.data_pct);
+    in.get(ph.ctrl_pct);
+    in.get(ph.sim_ticks);
+    in.get(ph.network_cycles);
+    in.get(ph.lambda);
+    in.get(ph.avg_packet_latency);
+    in.get(ph.variance);
+    in.get(ph.mshr_limit);
+    in.get(ph.vnet_packets);
+    in.get(ph.per_router_injection);
+    in.get(ph.dir_fractions);
+
+    in.get(ph.per_router_prob);
+    in.get(ph.vnet0_prob);
+    in.get(ph.vnet1_prob);
+    in.get(ph.vnet2_prob);
+    in.get(ph.response_data_prob);
+
+    in.get(ph.router_prob);
+    in.get(ph.vnet_alias);
+    in.get(ph.dir_ids);
+    in.get(ph.dir_alias);
+}
+
+} // namespace
+
+void PaceProfile::save_image(const std::string& path) const
+{
+    ImageOut out(path);
+    for (char c : kImageMagic) out.put(c);
+    out.put(kImageVersion);
+    out.put(kByteOrderMark);
+
+    out.put(num_cpus);
+    out.put(num_dirs);
+    out.put(mesh_rows);
+    out.put(mesh_cols);
+    out.put(mem_channels);
+    out.put(num_phases);
+    out.put(benchmark);
+    out.put(topo_id);
+    out.put(effective_lambda);
+    out.put(model.flit_width_bytes);
+    out.put(model.cacheline_bytes);
+    out.put(model.data_packet_flits);
+    out.put(model.ctrl_packet_flits);
+    out.put(directory_remapping);
+
+    out.put((uint64_t)phases.size());
+    for (const auto& ph : phases) save_phase(out, ph);
+
+    if (!out.ok())
+        throw std::runtime_error("Cannot write PACE profile image: " + path);
+}
+
+bool PaceProfile::is_image(const std::string& path)
+{
+    std::ifstream f(path, std::ios::binary);
+    char magic[sizeof(kImageMagic)] = {};
+    f.read(magic, sizeof(magic));
+    return f && std::memcmp(magic, kImageMagic, sizeof(magic)) == 0;
+}
+
+PaceProfile PaceProfile::load_image(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        if (fd >= 0) close(fd);
+        throw std::runtime_error("Cannot open PACE profile: " + path);
+    }
+    size_t size = (size_t)st.st_size;
+    void* map = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)
+                         : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED)
+        throw std::runtime_error("Cannot map PACE profile image: " + path);
+
+    ImageIn in(static_cast<const char*>(map), size);
+    PaceProfile prof;
+    std::string error;
+
+    char magic[sizeof(kImageMagic)];
+    for (char& c : magic) in.get(c);
+    uint32_t version = 0, byte_order = 0;
+    in.get(version);
+    in.get(byte_order);
+    if (std::memcmp(magic, kImageMagic, sizeof(magic)) != 0) {
+        error = "not a PACE profile image";
+    } else if (version != kImageVersion) {
+        error = "image version " + std::to_string(version) + ", expected " +
+                std::to_string(kImageVersion) + " (recompile the profile)";
+    } else if (byte_order != kByteOrderMark) {
+        error = "image was compiled on a host of different byte order";
+    } else {
+        in.get(prof.num_cpus);
+        in.get(prof.num_dirs);
+        in.get(prof.mesh_rows);
+        in.get(prof.mesh_cols);
+        in.get(prof.mem_channels);
+        in.get(prof.num_phases);
+        in.get(prof.benchmark);
+        in.get(prof.topo_id);
+        in.get(prof.effective_lambda);
+        in.get(prof.model.flit_width_bytes);
+        in.get(prof.model.cacheline_bytes);
+        in.get(prof.model.data_packet_flits);
+        in.get(prof.model.ctrl_packet_flits);
+        in.get(prof.directory_remapping);
+
+        uint64_t num_phases = 0;
+        in.get(num_phases);
+        for (uint64_t i = 0; i < num_phases && in.ok(); ++i) {
+            prof.phases.emplace_back();
+            load_phase(in, prof.phases.back());
+        }
+        if (!in.ok() || !in.at_end())
+            error = "image is truncated or corrupt";
+    }
+    munmap(map, size);
+
+    if (!error.empty())
+        throw std::runtime_error("PACE profile " + path + ": " + error);
+    return prof;
+}
+
+std::shared_ptr<const PaceProfile> PaceProfile::shared(const std::string& path)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const PaceProfile>> profiles;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const PaceProfile>& profile = profiles[path];
+    if (!profile) profile = std::make_shared<const PaceProfile>(load(path));
+    return profile;
+}
+
+} // namespace garnet
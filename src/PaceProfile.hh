@@ -15,6 +15,9 @@
 #include <cctype>
 #include <cstdlib>
 #include <algorithm>
+#include <memory>
+
+#include "AliasTable.hh"
 
 namespace garnet {
 
@@ -229,8 +232,35 @@ struct PacePhase {
     double                             vnet0_prob;
     double                             vnet1_prob;
     double                             vnet2_prob;
-    std::vector<std::pair<int,double>> dir_cumulative;    // {dir_id, cumulative_prob}
     double                             response_data_prob; // P(response is 5 flits)
+
+    // --- compiled from the above by compile(), for the per-injection lookups ---
+    std::vector<double> router_prob;   // router_id -> prob/cycle (0 if absent)
+    AliasTable          vnet_alias;    // vnet 0..2, weighted by vnetN_prob
+    std::vector<int>    dir_ids;       // dir_fractions keys, in key order
+    AliasTable          dir_alias;     // index into dir_ids, weighted by fraction
+
+    // Rebuild the compiled tables; call after changing per_router_prob,
+    // the vnet probabilities or dir_fractions.
+    void compile()
+    {
+        int max_router = -1;
+        for (const auto& kv : per_router_prob)
+            max_router = std::max(max_router, kv.first);
+        router_prob.assign(max_router + 1, 0.0);
+        for (const auto& kv : per_router_prob)
+            if (kv.first >= 0) router_prob[kv.first] = kv.second;
+
+        vnet_alias.build({vnet0_prob, vnet1_prob, vnet2_prob});
+
+        std::vector<double> weights;
+        dir_ids.clear();
+        for (const auto& kv : dir_fractions) {
+            dir_ids.push_back(kv.first);
+            weights.push_back(kv.second);
+        }
+        dir_alias.build(weights);
+    }
 };
 
 struct PaceModelAssumptions {
@@ -256,8 +286,11 @@ struct PaceProfile {
     PaceModelAssumptions        model;
     std::map<int, int>          directory_remapping; // dir_id -> router_id in target topo
 
+    // A compiled image (see save_image()) or a JSON profile.
     static PaceProfile load(const std::string& path)
     {
+        if (is_image(path)) return load_image(path);
+
         std::ifstream f(path);
         if (!f.is_open())
             throw std::runtime_error("Cannot open PACE profile: " + path);
@@ -341,13 +374,6 @@ struct PaceProfile {
             ph.vnet2_prob = 1.0 - ph.vnet0_prob - ph.vnet1_prob;
             if (ph.vnet2_prob < 0.0) ph.vnet2_prob = 0.0;
 
-            // Derive cumulative dir_fractions for weighted selection
-            double cum = 0.0;
-            for (const auto& kv : ph.dir_fractions) {
-                cum += kv.second;
-                ph.dir_cumulative.push_back({kv.first, cum});
-            }
-
             // Derive response data probability
             // vnet1_flits = total_flits - vnet0_flits(=vpkt(0)) - vnet2_flits(=vpkt(2)*data_flits)
             int64_t v0f = vpkt(0);          // ctrl: 1 flit each
@@ -357,6 +383,7 @@ struct PaceProfile {
             double data_resp = (double)(v1f - v1p) / (4.0 * v1p);
             ph.response_data_prob = std::max(0.0, std::min(1.0, data_resp));
 
+            ph.compile();
             prof.phases.push_back(ph);
         }
 
@@ -375,6 +402,20 @@ struct PaceProfile {
 
         return prof;
     }
+
+    // Compiled images (--compile-profile): the profile with its derived and
+    // compiled per-phase tables, in host byte order.  load_image() decodes
+    // one in a single pass of raw copies into the same tables a JSON load
+    // builds, without tokenizing or deriving anything; it keeps no
+    // reference to the file.
+    // Images carry a version and are rejected by other builds' formats.
+    void save_image(const std::string& path) const;
+    static PaceProfile load_image(const std::string& path);
+    static bool is_image(const std::string& path);
+
+    // The profile at `path`, loaded once per process and shared read-only
+    // by every caller (sweep points, saturation probes, their threads).
+    static std::shared_ptr<const PaceProfile> shared(const std::string& path);
 };
 
 } // namespace garnet
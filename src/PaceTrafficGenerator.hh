@@ -11,9 +11,11 @@
 #include <cassert>
 
 #include "flit.hh"
+#include "flitBuffer.hh"
 #include "GarnetNetwork.hh"
 #include "NetworkInterface.hh"
 #include "CommonTypes.hh"
+#include "CounterRng.hh"
 #include "PaceProfile.hh"
 #include "TrafficGenerator.hh"
 
@@ -68,19 +70,26 @@ public:
     void set_active(bool)           override {}
     void set_injection_rate(double) override {}
     void set_trace_packet(bool t)   override { m_trace = t; }
-    void set_seed(int seed)         override { m_rng.seed(seed + m_id); }
-    void schedule_next_injection(uint64_t) override {}
-    uint64_t get_next_injection_time() const override { return 0; }
+    void set_seed(int seed)         override { seed_streams(seed); }
+    void schedule_next_injection(uint64_t from) override;
+    uint64_t get_next_injection_time() const override;
+    void skip_idle_cycles(uint64_t cycles) override {
+        m_injection_attempts += cycles;
+    }
 
-    // Exposed for adapter use
-    std::mt19937& rng() { return m_rng; }
-    std::uniform_real_distribution<double>& dist() { return m_dist; }
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp)        override;
 
 private:
     // Implementations defined in PaceAdapter.cc
     void generate_packet(int dest_ni, int dest_router, int vnet,
                          int num_flits, uint64_t time);
     uint64_t current_time() const;
+    void seed_streams(int seed);
+    // A cycle in which a core does not get to its injection decision.
+    void skip_decision(uint64_t t);
+    // Draws the cycle of the next MSHR drain at or after `from`.
+    void schedule_drain(uint64_t from);
 
     // --- State ---
     int               m_id;
@@ -101,7 +110,22 @@ private:
     double m_prob_stay_off;
     int    m_last_phase_idx;
 
-    std::queue<flit*>         m_flit_queue;      // current outbound packet
+    // Injection decisions are drawn ahead (see schedule_next_injection):
+    // the next injecting decision falls on m_next_injection if the core
+    // decides every cycle until then, and m_deferred cycles later for the
+    // cycles it was busy instead.  m_burst_left counts the injecting
+    // decisions left in the current ON period (0: not started).
+    uint64_t m_next_injection;
+    uint64_t m_deferred;
+    uint64_t m_last_busy_cycle;
+    uint64_t m_burst_left;
+
+    // One outstanding request drains per cycle with probability
+    // 1 / avg latency of the phase drawn for.
+    uint64_t m_next_drain;
+    int      m_drain_phase;
+
+    flitBuffer                m_flit_queue;      // current outbound packet
     flit*                     m_stalled_flit;    // requeued if NI VC was full
     std::queue<ResponseJob>   m_pending_responses;
 
@@ -116,7 +140,10 @@ private:
     std::vector<uint64_t> m_latency_per_vnet;
 
     bool m_trace;
-    std::mt19937 m_rng;
+    CounterRng m_injection_rng;
+    CounterRng m_packet_rng;
+    CounterRng m_drain_rng;
+    CounterRng m_response_rng;
     std::uniform_real_distribution<double> m_dist;
 };
 
@@ -13,43 +13,152 @@
 namespace garnet
 {
 
+struct Router::Kernels
+{
+    typedef void (Router::*Kernel)();
+
+    template <int Ports, int VcsPerVnet>
+    static Kernel
+    get()
+    {
+        return &Router::wakeup_units<Ports, VcsPerVnet>;
+    }
+};
+
 Router::Router(const Params &p)
-  : m_id(p.id), m_x(p.x), m_y(p.y), m_z(p.z), m_latency(p.latency),
+  : m_id(p.id), m_chiplet(p.chiplet), m_x(p.x), m_y(p.y), m_z(p.z), m_latency(p.latency),
     m_virtual_networks(p.virtual_networks), m_vc_per_vnet(p.vcs_per_vnet),
     m_num_vcs(m_virtual_networks * m_vc_per_vnet),
-    m_network_ptr(p.network_ptr)
+    m_network_ptr(p.network_ptr), m_kernel(&Router::wakeup_units<0, 0>)
 {
-    m_routing_unit = new RoutingUnit(this);
-    m_sw_alloc = new SwitchAllocator(this);
-    m_crossbar_switch = new CrossbarSwitch(this);
+    set_kind(ROUTER);
+    m_routing_unit = m_arena.create<RoutingUnit>(this);
+    m_sw_alloc = m_arena.create<SwitchAllocator>(this);
     m_input_unit.clear();
     m_output_unit.clear();
 }
 
+// The arena destroys the units.
 Router::~Router()
 {
-    delete m_routing_unit;
-    delete m_sw_alloc;
-    delete m_crossbar_switch;
 }
 
 void
 Router::init()
 {
+    if (!m_crossbar_switch)
+        buildCrossbar();
+
+    for (auto& input_unit : m_input_unit)
+        input_unit->init();
     m_sw_alloc->init();
     m_crossbar_switch->init();
+    m_kernel = selectRouterKernel<Kernels>(get_shape());
+}
+
+// The crossbar has one buffer per inport, so it waits for the last.
+void
+Router::buildCrossbar()
+{
+    assert(!m_crossbar_switch);
+    m_crossbar_switch = m_arena.create<CrossbarSwitch>(this);
+}
+
+RouterShape
+Router::get_shape()
+{
+    RouterShape shape;
+    shape.inports = get_num_inports();
+    shape.outports = get_num_outports();
+    shape.vcs_per_vnet = m_vc_per_vnet;
+    shape.num_vcs = m_num_vcs;
+    shape.generic = m_network_ptr->useGenericRouterKernels();
+    return shape;
+}
+
+std::vector<NetworkLink*>
+Router::getOutboundLinks()
+{
+    std::vector<NetworkLink*> links;
+    for (auto& output_unit : m_output_unit)
+        links.push_back(output_unit->get_out_link());
+    for (auto& input_unit : m_input_unit)
+        links.push_back(input_unit->get_credit_link());
+    return links;
+}
+
+void
+Router::getSimObjects(std::vector<GarnetSimObject*>& objects)
+{
+    objects.push_back(this);
+    objects.push_back(m_sw_alloc);
+    objects.push_back(m_crossbar_switch);
+    for (auto& input_unit : m_input_unit)
+        objects.push_back(input_unit);
+    for (auto& output_unit : m_output_unit)
+        objects.push_back(output_unit);
+}
+
+void
+Router::saveState(CheckpointOut& cp) const
+{
+    Consumer::saveState(cp);
+    cp.put(m_buffered_flits);
+}
+
+void
+Router::loadState(CheckpointIn& cp)
+{
+    Consumer::loadState(cp);
+    cp.get(m_buffered_flits);
 }
 
 void
 Router::wakeup()
 {
-    for (int inport = 0; inport < (int)m_input_unit.size(); inport++) {
+    (this->*m_kernel)();
+}
+
+template <int Ports, int VcsPerVnet>
+void
+Router::wakeup_units()
+{
+    const int num_inports = Ports ? Ports : (int)m_input_unit.size();
+    const int num_outports = Ports ? Ports : (int)m_output_unit.size();
+    for (int inport = 0; inport < num_inports; inport++) {
         m_input_unit[inport]->wakeup();
     }
-    for (int outport = 0; outport < (int)m_output_unit.size(); outport++) {
+    for (int outport = 0; outport < num_outports; outport++) {
         m_output_unit[outport]->wakeup();
     }
-    m_sw_alloc->wakeup();
+    // Switch allocation and traversal only concern buffered flits.
+    if (m_buffered_flits != 0) m_sw_alloc->wakeup();
+    m_crossbar_switch->wakeup();
+}
+
+void
+Router::wakeup_input_units()
+{
+    for (auto input_unit : m_input_unit)
+        input_unit->wakeup();
+}
+
+void
+Router::wakeup_output_units()
+{
+    for (auto output_unit : m_output_unit)
+        output_unit->wakeup();
+}
+
+void
+Router::wakeup_switch_allocator()
+{
+    if (m_buffered_flits != 0) m_sw_alloc->wakeup();
+}
+
+void
+Router::wakeup_crossbar()
+{
     m_crossbar_switch->wakeup();
 }
 
@@ -58,14 +167,15 @@ Router::addInPort(PortDirection inport_dirn,
                   NetworkLink *in_link, CreditLink *credit_link)
 {
     int port_num = m_input_unit.size();
-    InputUnit *input_unit = new InputUnit(port_num, inport_dirn, this);
+    InputUnit *input_unit =
+        m_arena.create<InputUnit>(port_num, inport_dirn, this);
     input_unit->set_in_link(in_link);
     input_unit->set_credit_link(credit_link);
     in_link->setLinkConsumer(this);
     in_link->setVcsPerVnet(get_vc_per_vnet());
     credit_link->setSourceQueue(input_unit->getCreditQueue());
     credit_link->setVcsPerVnet(get_vc_per_vnet());
-    m_input_unit.push_back(std::shared_ptr<InputUnit>(input_unit));
+    m_input_unit.push_back(input_unit);
     m_routing_unit->addInDirection(inport_dirn, port_num);
 
     // Add trace callback if needed or handle in wakeup
@@ -78,14 +188,15 @@ Router::addOutPort(PortDirection outport_dirn,
                    CreditLink *credit_link, uint32_t consumerVcs)
 {
     int port_num = m_output_unit.size();
-    OutputUnit *output_unit = new OutputUnit(port_num, outport_dirn, this, consumerVcs);
+    OutputUnit *output_unit = m_arena.create<OutputUnit>(
+        port_num, outport_dirn, this, consumerVcs);
     output_unit->set_out_link(out_link);
     output_unit->set_credit_link(credit_link);
     credit_link->setLinkConsumer(this);
     credit_link->setVcsPerVnet(consumerVcs);
     out_link->setSourceQueue(output_unit->getOutQueue());
     out_link->setVcsPerVnet(consumerVcs);
-    m_output_unit.push_back(std::shared_ptr<OutputUnit>(output_unit));
+    m_output_unit.push_back(output_unit);
     m_routing_unit->addRoute(routing_table_entry);
     m_routing_unit->addWeight(link_weight);
     m_routing_unit->addOutDirection(outport_dirn, port_num);
@@ -94,11 +205,12 @@ Router::addOutPort(PortDirection outport_dirn,
 PortDirection Router::getOutportDirection(int outport) { return m_output_unit[outport]->get_direction(); }
 PortDirection Router::getInportDirection(int inport) { return m_input_unit[inport]->get_direction(); }
 int Router::getOutportIndex(PortDirection dir) { return m_routing_unit->getOutportIndex(dir); }
-int Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn) { return m_routing_unit->outportCompute(route, inport, inport_dirn); }
+int Router::route_compute(const RouteInfo& route, int inport, PortDirection inport_dirn) { return m_routing_unit->outportCompute(route, inport, inport_dirn); }
 void Router::grant_switch(int inport, flit *t_flit) { m_crossbar_switch->update_sw_winner(inport, t_flit); }
-std::string Router::getPortDirectionName(PortDirection direction) { return direction; }
+std::string Router::getPortDirectionName(PortDirection direction) { return portDirectionName(direction); }
 void Router::scheduleEvent(uint64_t time) { m_network_ptr->getEventQueue()->schedule(this, time); }
 void Router::addRouteForPort(int port, int dest_ni) { m_routing_unit->addRouteForPort(port, dest_ni); }
+size_t Router::compileRoutingTable(int num_nis) { return m_routing_unit->compileRoutingTable(num_nis); }
 
 bool
 Router::get_fault_vector(int temperature, float fault_vector[])
@@ -36,9 +36,11 @@
 #include <memory>
 #include <vector>
 
+#include "Arena.hh"
 #include "CommonTypes.hh"
 #include "GarnetSimObject.hh"
 #include "Consumer.hh"
+#include "RouterKernel.hh"
 #include "flit.hh"
 
 namespace garnet
@@ -62,6 +64,7 @@ struct GarnetRouterParams {
     int vcs_per_vnet;
     uint64_t latency;
     GarnetNetwork *network_ptr;
+    int chiplet = 0;        // SimKernel keeps a chiplet in one partition
 };
 
 class Router : public Consumer
@@ -72,10 +75,12 @@ class Router : public Consumer
 
     ~Router();
 
-    void wakeup();
+    void wakeup() final;
     void print(std::ostream &out) const {};
 
     void init();
+    // Called by GarnetNetwork::init() once every port is added.
+    void buildCrossbar();
     void addInPort(PortDirection inport_dirn, NetworkLink *link,
                    CreditLink *credit_link);
     void addOutPort(PortDirection outport_dirn, NetworkLink *link,
@@ -85,6 +90,33 @@ class Router : public Consumer
 
     void scheduleEvent(uint64_t time) override;
 
+    // Flit and credit links fed by this router.
+    std::vector<NetworkLink*> getOutboundLinks();
+
+    // Appends the router and its units, in construction order.
+    void getSimObjects(std::vector<GarnetSimObject*>& objects);
+
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp) override;
+
+    // Flits held in input VCs, maintained by InputUnit/SwitchAllocator.
+    void increment_buffered_flits() { m_buffered_flits++; }
+    void decrement_buffered_flits() { m_buffered_flits--; }
+
+    // False when wakeup() would be a no-op: nothing buffered and nothing
+    // in flight on the incoming flit and credit links.
+    bool has_pending_work() const
+    {
+        return m_buffered_flits != 0 || has_inbound();
+    }
+
+    // The steps of wakeup(), for SimKernel's phased mode, which runs each
+    // of them for all woken routers before the next.
+    void wakeup_input_units();
+    void wakeup_output_units();
+    void wakeup_switch_allocator();
+    void wakeup_crossbar();
+
     uint64_t get_pipe_stages() { return m_latency; }
     uint32_t get_num_vcs() { return m_num_vcs; }
     uint32_t get_num_vnets() { return m_virtual_networks; }
@@ -92,6 +124,16 @@ class Router : public Consumer
     int get_num_inports() { return m_input_unit.size(); }
     int get_num_outports() { return m_output_unit.size(); }
     int get_id() { return m_id; }
+    int get_chiplet() const { return m_chiplet; }
+
+    // Picks the router kernels in init(); see RouterKernel.hh.
+    RouterShape get_shape();
+
+    // Holds the router's units, VCs and crossbar buffers and the links
+    // into its inports (see Topology).
+    Arena& getArena() { return m_arena; }
+    // This object plus its arena.
+    size_t getStateBytes() const { return sizeof(Router) + m_arena.bytes_used(); }
 
     int get_x() const { return m_x; }
     int get_y() const { return m_y; }
@@ -103,14 +145,14 @@ class Router : public Consumer
     getInputUnit(unsigned port)
     {
         assert(port < m_input_unit.size());
-        return m_input_unit[port].get();
+        return m_input_unit[port];
     }
 
     OutputUnit*
     getOutputUnit(unsigned port)
     {
         assert(port < m_output_unit.size());
-        return m_output_unit[port].get();
+        return m_output_unit[port];
     }
 
     PortDirection getOutportDirection(int outport);
@@ -118,10 +160,12 @@ class Router : public Consumer
 
     int getOutportIndex(PortDirection dir);
 
-    int route_compute(RouteInfo route, int inport, PortDirection direction);
+    int route_compute(const RouteInfo& route, int inport, PortDirection direction);
     void grant_switch(int inport, flit *t_flit);
 
     void addRouteForPort(int port, int dest_ni);
+    // See RoutingUnit::compileRoutingTable().
+    size_t compileRoutingTable(int num_nis);
 
     std::string getPortDirectionName(PortDirection direction);
 
@@ -131,18 +175,29 @@ class Router : public Consumer
     void printAggregateFaultProbability(std::ostream& out);
 
   private:
+    // Wakes the units of a router with `Ports` inports and outports; <0, 0>
+    // works for any router.
+    template <int Ports, int VcsPerVnet> void wakeup_units();
+    struct Kernels;
+
+    // Declared first: the units in it are destroyed last.
+    Arena m_arena;
+
     int m_id;
+    int m_chiplet;
     int m_x, m_y, m_z;
     uint64_t m_latency;
     uint32_t m_virtual_networks, m_vc_per_vnet, m_num_vcs;
     GarnetNetwork *m_network_ptr;
+    uint64_t m_buffered_flits = 0;
+    void (Router::*m_kernel)();
 
     RoutingUnit* m_routing_unit;
     SwitchAllocator* m_sw_alloc;
-    CrossbarSwitch* m_crossbar_switch;
+    CrossbarSwitch* m_crossbar_switch = nullptr;   // see buildCrossbar()
 
-    std::vector<std::shared_ptr<InputUnit>> m_input_unit;
-    std::vector<std::shared_ptr<OutputUnit>> m_output_unit;
+    std::vector<InputUnit*> m_input_unit;
+    std::vector<OutputUnit*> m_output_unit;
 };
 
 } // namespace garnet
@@ -0,0 +1,89 @@
+// Router pipeline kernels compiled for a fixed radix and VC count.
+//
+// Router::wakeup, the switch allocator and the crossbar loop over ports and
+// VCs whose numbers are only known once the topology is built.  Each of
+// them also has a member template taking the port count and the VCs per
+// vnet as constants: the port loops get constexpr bounds the compiler can
+// unroll, mapping a VC to its vnet is a division by a constant, and the
+// per-port VC and request masks are scanned as single words.  Arguments of
+// 0 select the generic version driven by the runtime sizes.
+//
+// Router::init() picks the instantiation for the router's shape.  Shapes
+// with as many inports as outports, kRouterKernelMinPorts to
+// kRouterKernelMaxPorts of them (2D and 3D mesh routers, including edges
+// and corners), up to kRouterKernelMaxVcsPerVnet VCs per vnet and at most
+// 64 VCs per port are compiled; any other router runs the generic kernel.
+// All kernels make the same decisions.
+
+#ifndef __GARNET_ROUTER_KERNEL_HH__
+#define __GARNET_ROUTER_KERNEL_HH__
+
+namespace garnet {
+
+const int kRouterKernelMinPorts = 3;
+const int kRouterKernelMaxPorts = 7;
+const int kRouterKernelMaxVcsPerVnet = 4;
+
+// Size of the router a kernel is picked for.
+struct RouterShape {
+    int inports;
+    int outports;
+    int vcs_per_vnet;
+    int num_vcs;
+    bool generic;       // --router-kernel generic: never specialise
+
+    bool
+    has_fixed_kernel() const
+    {
+        return !generic && inports == outports &&
+               inports >= kRouterKernelMinPorts &&
+               inports <= kRouterKernelMaxPorts &&
+               vcs_per_vnet >= 1 &&
+               vcs_per_vnet <= kRouterKernelMaxVcsPerVnet &&
+               num_vcs <= 64;
+    }
+};
+
+// Walks the compiled shapes from the largest; Table::get<Ports,
+// VcsPerVnet>() returns the kernel of one of them.
+template <typename Table, int I>
+struct RouterKernelSelect {
+    static const int kPorts =
+        kRouterKernelMinPorts + I / kRouterKernelMaxVcsPerVnet;
+    static const int kVcsPerVnet = 1 + I % kRouterKernelMaxVcsPerVnet;
+
+    static typename Table::Kernel
+    get(int ports, int vcs_per_vnet)
+    {
+        if (ports == kPorts && vcs_per_vnet == kVcsPerVnet)
+            return Table::template get<kPorts, kVcsPerVnet>();
+        return RouterKernelSelect<Table, I - 1>::get(ports, vcs_per_vnet);
+    }
+};
+
+template <typename Table>
+struct RouterKernelSelect<Table, -1> {
+    static typename Table::Kernel
+    get(int, int)
+    {
+        return Table::template get<0, 0>();
+    }
+};
+
+// The kernel Table provides for `shape`.
+template <typename Table>
+typename Table::Kernel
+selectRouterKernel(const RouterShape& shape)
+{
+    if (!shape.has_fixed_kernel())
+        return Table::template get<0, 0>();
+    const int num_shapes =
+        (kRouterKernelMaxPorts - kRouterKernelMinPorts + 1) *
+        kRouterKernelMaxVcsPerVnet;
+    return RouterKernelSelect<Table, num_shapes - 1>::get(
+        shape.inports, shape.vcs_per_vnet);
+}
+
+} // namespace garnet
+
+#endif // __GARNET_ROUTER_KERNEL_HH__
@@ -72,38 +72,51 @@ RoutingUnit::supportsVnet(int vnet, std::vector<int> sVnets)
     return false;
 }
 
+// First link with the lowest weight among those reaching a destination.
 int
 RoutingUnit::lookupRoutingTable(int vnet, const NetDest& msg_destination)
 {
-    int min_weight = -1; 
-    std::vector<int> output_link_candidates;
-
     if (vnet >= (int)m_routing_table.size()) return -1;
 
-    for (int link = 0; link < (int)m_routing_table[vnet].size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[vnet][link])) {
-            int weight = 1;
-            if (link < (int)m_weight_table.size()) weight = m_weight_table[link];
-            if (weight <= min_weight || min_weight == -1) min_weight = weight;
+    const std::vector<NetDest>& links = m_routing_table[vnet];
+    int best_link = -1;
+    int min_weight = -1;
+    for (int link = 0; link < (int)links.size(); link++) {
+        if (!msg_destination.intersectionIsNotEmpty(links[link])) continue;
+        int weight = 1;
+        if (link < (int)m_weight_table.size()) weight = m_weight_table[link];
+        if (best_link == -1 || weight < min_weight) {
+            best_link = link;
+            min_weight = weight;
         }
     }
+    return best_link;
+}
 
-    for (int link = 0; link < (int)m_routing_table[vnet].size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[vnet][link])) {
-            int weight = 1;
-            if (link < (int)m_weight_table.size()) weight = m_weight_table[link];
-            if (weight == min_weight) output_link_candidates.push_back(link);
-        }
+size_t
+RoutingUnit::compileRoutingTable(int num_nis)
+{
+    m_compiled_nis = num_nis;
+    m_compiled_routes.assign(m_routing_table.size() * num_nis, -1);
+    NetDest dest;
+    for (int d = 0; d < num_nis; d++) {
+        dest.clear();
+        dest.add(d);
+        for (int v = 0; v < (int)m_routing_table.size(); v++)
+            m_compiled_routes[v * num_nis + d] =
+                (int16_t)lookupRoutingTable(v, dest);
     }
-
-    if (output_link_candidates.size() == 0) return -1;
-    return output_link_candidates.at(0);
+    return m_compiled_routes.size() * sizeof(int16_t);
 }
 
 
 void
 RoutingUnit::addInDirection(PortDirection inport_dirn, int inport_idx)
 {
+    if (inport_dirn >= (int)m_inports_dirn2idx.size())
+        m_inports_dirn2idx.resize(inport_dirn + 1, -1);
+    if (inport_idx >= (int)m_inports_idx2dirn.size())
+        m_inports_idx2dirn.resize(inport_idx + 1, -1);
     m_inports_dirn2idx[inport_dirn] = inport_idx;
     m_inports_idx2dirn[inport_idx]  = inport_dirn;
 }
@@ -111,12 +124,16 @@ RoutingUnit::addInDirection(PortDirection inport_dirn, int inport_idx)
 void
 RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
 {
+    if (outport_dirn >= (int)m_outports_dirn2idx.size())
+        m_outports_dirn2idx.resize(outport_dirn + 1, -1);
+    if (outport_idx >= (int)m_outports_idx2dirn.size())
+        m_outports_idx2dirn.resize(outport_idx + 1, -1);
     m_outports_dirn2idx[outport_dirn] = outport_idx;
     m_outports_idx2dirn[outport_idx]  = outport_dirn;
 }
 
 int
-RoutingUnit::outportCompute(RouteInfo route, int inport,
+RoutingUnit::outportCompute(const RouteInfo& route, int inport,
                             PortDirection inport_dirn)
 {
     int outport = -1;
@@ -125,19 +142,31 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
     } 
     
     // Fallback if XY routing is disabled or fails
+    // Packets are unicast and the generators leave net_dest empty: dest_ni
+    // is the whole destination set.
     if (outport == -1) {
-         outport = lookupRoutingTable(route.vnet, route.net_dest);
+        if (route.dest_ni < m_compiled_nis &&
+            route.vnet < (int)m_routing_table.size()) {
+            outport = m_compiled_routes[route.vnet * m_compiled_nis +
+                                        route.dest_ni];
+        } else if (!route.net_dest.isEmpty()) {
+            outport = lookupRoutingTable(route.vnet, route.net_dest);
+        } else {
+            NetDest dest;
+            dest.add(route.dest_ni);
+            outport = lookupRoutingTable(route.vnet, dest);
+        }
     }
 
     return outport;
 }
 
 int
-RoutingUnit::outportComputeXY(RouteInfo route,
+RoutingUnit::outportComputeXY(const RouteInfo& route,
                               int inport,
                               PortDirection inport_dirn)
 {
-    PortDirection outport_dirn = "Unknown";
+    PortDirection outport_dirn;
 
     int my_x = m_router->get_x();
     int my_y = m_router->get_y();
@@ -162,22 +191,20 @@ RoutingUnit::outportComputeXY(RouteInfo route,
     int dest_z = dest_id / (num_cols * num_rows);
 
     if (dest_x != my_x) {
-        outport_dirn = (dest_x > my_x) ? "East" : "West";
+        outport_dirn = (dest_x > my_x) ? EAST_DIRN_ : WEST_DIRN_;
     } else if (dest_y != my_y) {
-        outport_dirn = (dest_y > my_y) ? "South" : "North";
+        outport_dirn = (dest_y > my_y) ? SOUTH_DIRN_ : NORTH_DIRN_;
     } else if (dest_z != my_z) {
-        outport_dirn = (dest_z > my_z) ? "Up" : "Down";
+        outport_dirn = (dest_z > my_z) ? UP_DIRN_ : DOWN_DIRN_;
     } else {
-        outport_dirn = "Local";
+        outport_dirn = LOCAL_DIRN_;
     }
 
-    auto it = m_outports_dirn2idx.find(outport_dirn);
-    if (it == m_outports_dirn2idx.end()) return -1;
-    return it->second;
+    return getOutportIndex(outport_dirn);
 }
 
 int
-RoutingUnit::outportComputeCustom(RouteInfo route,
+RoutingUnit::outportComputeCustom(const RouteInfo& route,
                                  int inport,
                                  PortDirection inport_dirn)
 {
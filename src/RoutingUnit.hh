@@ -32,7 +32,6 @@
 #define __GARNET_ROUTING_UNIT_HH__
 
 #include <vector>
-#include <map>
 
 #include "CommonTypes.hh"
 #include "Router.hh"
@@ -49,7 +48,7 @@ class RoutingUnit
 {
   public:
     RoutingUnit(Router *router);
-    int outportCompute(RouteInfo route,
+    int outportCompute(const RouteInfo& route,
                       int inport,
                       PortDirection inport_dirn);
 
@@ -61,8 +60,14 @@ class RoutingUnit
     // get output port from routing table
     int  lookupRoutingTable(int vnet, const NetDest& net_dest);
 
+    // Resolves the routing table into one outport per (vnet, destination
+    // NI) for NIs [0, num_nis), so a packet is routed with a single load.
+    // Call once the topology is built, with table routing only; returns
+    // the compiled table's size in bytes.
+    size_t compileRoutingTable(int num_nis);
+
     int getOutportIndex(PortDirection dir) {
-        if (m_outports_dirn2idx.find(dir) != m_outports_dirn2idx.end())
+        if (dir >= 0 && dir < (int)m_outports_dirn2idx.size())
             return m_outports_dirn2idx[dir];
         return -1;
     }
@@ -72,12 +77,12 @@ class RoutingUnit
     void addOutDirection(PortDirection outport_dirn, int outport);
 
     // Routing for Mesh
-    int outportComputeXY(RouteInfo route,
+    int outportComputeXY(const RouteInfo& route,
                          int inport,
                          PortDirection inport_dirn);
 
     // Custom Routing Algorithm using Port Directions
-    int outportComputeCustom(RouteInfo route,
+    int outportComputeCustom(const RouteInfo& route,
                              int inport,
                              PortDirection inport_dirn);
 
@@ -92,12 +97,17 @@ class RoutingUnit
     // Routing Table
     std::vector<std::vector<NetDest>> m_routing_table;
     std::vector<int> m_weight_table;
+    // compileRoutingTable(): outport for vnet v and NI d at
+    // [v * m_compiled_nis + d], -1 if unreachable.
+    std::vector<int16_t> m_compiled_routes;
+    int m_compiled_nis = 0;
 
     // Inport and Outport direction to idx maps
-    std::map<PortDirection, int> m_inports_dirn2idx;
-    std::map<int, PortDirection> m_inports_idx2dirn;
-    std::map<int, PortDirection> m_outports_idx2dirn;
-    std::map<PortDirection, int> m_outports_dirn2idx;
+    // (indexed by direction ID or port index, -1 if none)
+    std::vector<int> m_inports_dirn2idx;
+    std::vector<PortDirection> m_inports_idx2dirn;
+    std::vector<PortDirection> m_outports_idx2dirn;
+    std::vector<int> m_outports_dirn2idx;
 };
 
 } // namespace garnet
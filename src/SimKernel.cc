@@ -0,0 +1,404 @@
+#include "SimKernel.hh"
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+
+#include "FlitPool.hh"
+#include "GarnetNetwork.hh"
+#include "InputUnit.hh"
+#include "NetworkBridge.hh"
+#include "NetworkInterface.hh"
+#include "NetworkLink.hh"
+#include "OutputUnit.hh"
+#include "Router.hh"
+
+namespace garnet {
+
+bool SimKernel::parse_mode(const std::string& name, Mode& mode)
+{
+    if (name == "sweep")    { mode = FULL_SWEEP;      return true; }
+    if (name == "activity") { mode = ACTIVITY_DRIVEN; return true; }
+    if (name == "phased")   { mode = PHASED;          return true; }
+    return false;
+}
+
+SimKernel::SimKernel(GarnetNetwork* net,
+                     const std::vector<NetworkInterface*>& nis,
+                     const std::vector<Router*>& routers, Mode mode,
+                     int threads)
+    : m_net(net), m_mode(mode)
+{
+    std::unique_ptr<Partition> whole(new Partition);
+    whole->queue = net->getEventQueue();
+    whole->nis = nis;
+    whole->routers = routers;
+    m_parts.push_back(std::move(whole));
+
+    if (threads > 1 && routers.size() > 1) partition(threads);
+    if (m_parts.size() > 1)
+        std::cout << "SimKernel: " << m_parts.size() << " partitions, "
+                  << m_lookahead << "-cycle windows\n";
+
+    reserve(*m_parts[0]);
+    for (size_t p = 1; p < m_parts.size(); ++p)
+        m_workers.emplace_back(&SimKernel::worker, this,
+                               std::ref(*m_parts[p]));
+    // Wait for the workers' reservations.
+    if (!m_workers.empty()) barrier();
+}
+
+SimKernel::~SimKernel()
+{
+    if (!m_workers.empty()) {
+        m_stop = true;
+        barrier();
+        for (auto& worker : m_workers) worker.join();
+    }
+    for (auto link : m_remote_links) link->setOutbox(nullptr);
+}
+
+// Splits the single partition set up by the constructor, unless a link
+// that cannot use an outbox would cross partitions.
+void SimKernel::partition(int threads)
+{
+    const std::vector<NetworkInterface*> nis = m_parts[0]->nis;
+    const std::vector<Router*> routers = m_parts[0]->routers;
+
+    // With several chiplets, a partition takes a contiguous run of whole
+    // chiplets, so that only inter-chiplet links cross partitions.
+    std::unordered_map<int, int> chiplet_index;
+    for (auto router : routers)
+        chiplet_index.emplace(router->get_chiplet(), (int)chiplet_index.size());
+    size_t num_units = chiplet_index.size() > 1 ? chiplet_index.size()
+                                                : routers.size();
+    int num_parts = (int)std::min<size_t>(threads, num_units);
+
+    // Owner partition of every simulated object.
+    std::unordered_map<const GarnetSimObject*, int> owner;
+    std::vector<std::pair<NetworkLink*, int>> links;
+    std::unordered_map<int, int> router_part;
+    for (size_t i = 0; i < routers.size(); ++i) {
+        Router* router = routers[i];
+        size_t unit = chiplet_index.size() > 1
+                      ? chiplet_index[router->get_chiplet()] : i;
+        int p = (int)(unit * num_parts / num_units);
+        router_part[router->get_id()] = p;
+        owner[router] = p;
+        for (int port = 0; port < router->get_num_inports(); ++port)
+            owner[router->getInputUnit(port)] = p;
+        for (int port = 0; port < router->get_num_outports(); ++port)
+            owner[router->getOutputUnit(port)] = p;
+        for (auto link : router->getOutboundLinks())
+            links.emplace_back(link, p);
+    }
+    std::vector<int> ni_part(nis.size(), 0);
+    for (size_t i = 0; i < nis.size(); ++i) {
+        auto it = router_part.find(nis[i]->get_router_id(0));
+        if (it != router_part.end()) ni_part[i] = it->second;
+        owner[nis[i]] = ni_part[i];
+        for (auto link : nis[i]->getOutboundLinks())
+            links.emplace_back(link, ni_part[i]);
+    }
+    for (const auto& link : links) owner[link.first] = link.second;
+
+    auto fall_back = [&](const std::string& reason) {
+        std::cerr << "WARNING: --threads " << threads << ": " << reason
+                  << "; simulating on one thread\n";
+    };
+    for (const auto& link : links) {
+        auto consumer = owner.find(link.first->getLinkConsumer());
+        if (consumer == owner.end()) {
+            fall_back("link " + std::to_string(link.first->get_id()) +
+                      " feeds neither a router nor an NI");
+            return;
+        }
+        // A flit that reaches the consumer in the cycle it left would have
+        // to cross in the middle of a window.
+        if (consumer->second != link.second &&
+            link.first->get_min_delay() == 0) {
+            fall_back("link " + std::to_string(link.first->get_id()) +
+                      " crosses partitions without delay");
+            return;
+        }
+        // A bridge updates its co-bridge directly.
+        auto bridge = dynamic_cast<NetworkBridge*>(link.first);
+        if (bridge && bridge->getCoBridge()) {
+            auto co = owner.find(bridge->getCoBridge());
+            if (co == owner.end() || co->second != link.second) {
+                fall_back("bridge " + std::to_string(bridge->get_id()) +
+                          " and its co-bridge would be in different "
+                          "partitions");
+                return;
+            }
+        }
+    }
+
+    EventQueue* net_queue = m_parts[0]->queue;
+    m_parts.clear();
+    for (int p = 0; p < num_parts; ++p) {
+        std::unique_ptr<Partition> part(new Partition);
+        part->own_queue.reset(new EventQueue());
+        part->queue = part->own_queue.get();
+        part->queue->set_current_time(net_queue->get_current_time());
+        m_parts.push_back(std::move(part));
+    }
+    for (size_t i = 0; i < routers.size(); ++i)
+        m_parts[owner[routers[i]]]->routers.push_back(routers[i]);
+    for (size_t i = 0; i < nis.size(); ++i)
+        m_parts[ni_part[i]]->nis.push_back(nis[i]);
+
+    for (const auto& link : links) {
+        int dest = owner[link.first->getLinkConsumer()];
+        if (dest == link.second) continue;
+        // A window never exceeds the lookahead, so an outbox holds at most
+        // that many wakeups' flits between barriers.
+        m_outboxes.emplace_back(new SpscQueue<flit*>(
+            (link.first->get_min_delay() + 1) *
+            link.first->get_max_flits_per_wakeup()));
+        link.first->setOutbox(m_outboxes.back().get());
+        m_remote_links.push_back(link.first);
+        m_parts[dest]->inbound.emplace_back(link.first,
+                                            m_outboxes.back().get());
+        m_lookahead = std::min(m_lookahead, link.first->get_min_delay());
+    }
+
+    // Hand already scheduled wakeups to their owners' queues.
+    std::vector<std::vector<Event>> moved(num_parts);
+    for (const auto& event : net_queue->take_all()) {
+        auto it = owner.find(event.get_obj());
+        moved[it != owner.end() ? it->second : 0].push_back(event);
+    }
+    for (int p = 0; p < num_parts; ++p) m_parts[p]->queue->put_back(moved[p]);
+}
+
+void SimKernel::run(uint64_t start, uint64_t end)
+{
+    if (m_workers.empty()) {
+        Partition& part = *m_parts[0];
+        for (uint64_t t = start; t < end; t = next_cycle(part, t, end))
+            run_cycle(part, t);
+        return;
+    }
+
+    m_run_start = start;
+    m_run_end = end;
+    for (auto& part : m_parts) part->next = start;
+
+    Partition& part = *m_parts[0];
+    GarnetNetwork::setThreadPartition(part.queue, &part.stats);
+    barrier();
+    run_partition(part, start, end);
+    barrier();
+    GarnetNetwork::setThreadPartition(nullptr, nullptr);
+}
+
+void SimKernel::run_cycle(Partition& part, uint64_t t)
+{
+    if (m_mode == PHASED) {
+        run_phased_cycle(part, t);
+        return;
+    }
+
+    EventQueue* event_queue = part.queue;
+    event_queue->set_current_time(t);
+
+    if (m_mode == FULL_SWEEP) {
+        for (auto ni : part.nis)         ni->wakeup();
+        for (auto router : part.routers) router->wakeup();
+    } else {
+        for (auto ni : part.nis)
+            if (ni->get_next_active_time() <= t) ni->wakeup();
+        for (auto router : part.routers)
+            if (router->has_pending_work()) router->wakeup();
+    }
+
+    while (!event_queue->is_empty() &&
+           event_queue->peek_next_time() <= t) {
+        Event ev = event_queue->get_next_event();
+        ev.get_obj()->wakeup();
+    }
+}
+
+// See SimKernel.hh for the order of the phases.
+void SimKernel::run_phased_cycle(Partition& part, uint64_t t)
+{
+    EventQueue* event_queue = part.queue;
+    event_queue->set_current_time(t);
+
+    for (auto ni : part.nis)
+        if (ni->get_next_active_time() <= t) ni->wakeup();
+    part.woken_routers.clear();
+    for (auto router : part.routers)
+        if (router->has_pending_work()) part.woken_routers.push_back(router);
+    wake_routers(part.woken_routers);
+
+    while (!event_queue->is_empty() &&
+           event_queue->peek_next_time() <= t) {
+        part.woken_nis.clear();
+        part.woken_routers.clear();
+        part.woken_output_units.clear();
+        part.woken_links.clear();
+        part.woken_others.clear();
+        while (!event_queue->is_empty() &&
+               event_queue->peek_next_time() <= t) {
+            GarnetSimObject* obj = event_queue->get_next_event().get_obj();
+            switch (obj->get_kind()) {
+              case GarnetSimObject::INTERFACE:
+                part.woken_nis.push_back(static_cast<NetworkInterface*>(obj));
+                break;
+              case GarnetSimObject::ROUTER:
+                part.woken_routers.push_back(static_cast<Router*>(obj));
+                break;
+              case GarnetSimObject::OUTPUT_UNIT:
+                part.woken_output_units.push_back(
+                    static_cast<OutputUnit*>(obj));
+                break;
+              case GarnetSimObject::LINK:
+                part.woken_links.push_back(static_cast<NetworkLink*>(obj));
+                break;
+              default:
+                part.woken_others.push_back(obj);
+                break;
+            }
+        }
+
+        for (auto ni : part.woken_nis) ni->wakeup();
+        wake_routers(part.woken_routers);
+        for (auto output_unit : part.woken_output_units)
+            output_unit->wakeup();
+        // LINK objects do not override NetworkLink::wakeup().
+        for (auto link : part.woken_links) link->NetworkLink::wakeup();
+        for (auto obj : part.woken_others) obj->wakeup();
+    }
+}
+
+void SimKernel::wake_routers(const std::vector<Router*>& routers)
+{
+    for (auto router : routers) router->wakeup_input_units();
+    for (auto router : routers) router->wakeup_output_units();
+    for (auto router : routers) router->wakeup_switch_allocator();
+    for (auto router : routers) router->wakeup_crossbar();
+}
+
+uint64_t SimKernel::next_cycle(const Partition& part, uint64_t t,
+                               uint64_t limit) const
+{
+    if (m_mode == FULL_SWEEP) return t + 1;
+
+    uint64_t next = std::min(limit, part.queue->peek_next_time());
+    if (next <= t + 1) return t + 1;
+
+    // Anything buffered or in flight keeps the clock ticking one cycle at
+    // a time; otherwise the next cycle with work is the earliest event or
+    // injection.
+    for (auto ni : part.nis) {
+        uint64_t active = ni->get_next_active_time();
+        if (active <= t + 1) return t + 1;
+        next = std::min(next, active);
+    }
+    for (auto router : part.routers)
+        if (router->has_pending_work()) return t + 1;
+    return next;
+}
+
+// Runs on every partition's thread at once.  Each window starts at the
+// earliest cycle any partition has work in, and ends at most a lookahead
+// later so no flit sent inside it can arrive inside it.
+void SimKernel::run_partition(Partition& part, uint64_t start, uint64_t end)
+{
+    uint64_t window_start = start;
+    while (window_start < end) {
+        uint64_t window_end = end - window_start > m_lookahead
+                              ? window_start + m_lookahead : end;
+        for (uint64_t t = std::max(window_start, part.next); t < window_end;
+             t = next_cycle(part, t, window_end))
+            run_cycle(part, t);
+
+        barrier();
+        deliver_inbound(part);
+        part.next = next_cycle(part, window_end - 1, end);
+        barrier();
+
+        window_start = end;
+        for (const auto& other : m_parts)
+            window_start = std::min(window_start, other->next);
+    }
+}
+
+void SimKernel::deliver_inbound(Partition& part)
+{
+    flit* t_flit;
+    for (const auto& in : part.inbound)
+        while (in.second->pop(t_flit)) in.first->deliver(t_flit);
+}
+
+void SimKernel::reserve(const Partition& part)
+{
+    // Every buffered flit holds a credit of the port it was sent on, and
+    // a credit on its way back stands for one such flit.
+    size_t objects = 0, credits = 0;
+    for (auto ni : part.nis) {
+        objects += 1 + ni->getOutboundLinks().size();
+        credits += ni->get_total_credits();
+    }
+    for (auto router : part.routers) {
+        std::vector<GarnetSimObject*> parts;
+        router->getSimObjects(parts);
+        objects += parts.size() + router->getOutboundLinks().size();
+        for (int port = 0; port < router->get_num_outports(); ++port)
+            credits += router->getOutputUnit(port)->get_total_credits();
+    }
+    part.queue->reserve(objects);
+    FlitPool::reserve(sizeof(flit), 2 * credits);
+    FlitPool::reserve(sizeof(PacketHeader), credits);
+}
+
+void SimKernel::worker(Partition& part)
+{
+    GarnetNetwork::setThreadPartition(part.queue, &part.stats);
+    reserve(part);
+    barrier();
+    for (;;) {
+        barrier();
+        if (m_stop) return;
+        run_partition(part, m_run_start, m_run_end);
+        barrier();
+    }
+}
+
+// Spin briefly, then yield: windows are usually a single cycle long.
+void SimKernel::barrier()
+{
+    uint64_t generation = m_barrier_generation.load(std::memory_order_acquire);
+    if (m_barrier_waiting.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+        (int)m_parts.size()) {
+        m_barrier_waiting.store(0, std::memory_order_relaxed);
+        m_barrier_generation.store(generation + 1, std::memory_order_release);
+        return;
+    }
+    for (int spins = 0;
+         m_barrier_generation.load(std::memory_order_acquire) == generation;
+         ++spins) {
+        if (spins >= 1000) std::this_thread::yield();
+    }
+}
+
+void SimKernel::finish(uint64_t end)
+{
+    for (auto& part : m_parts)
+        for (auto ni : part->nis) ni->sync_idle_cycles(end);
+    if (m_workers.empty()) return;
+
+    EventQueue* net_queue = m_net->getEventQueue();
+    uint64_t now = net_queue->get_current_time();
+    for (auto& part : m_parts) {
+        net_queue->put_back(part->queue->take_all());
+        net_queue->add_wakeup_counts(*part->queue);
+        m_net->getStats().merge(part->stats);
+        now = std::max(now, part->queue->get_current_time());
+    }
+    net_queue->set_current_time(now);
+}
+
+} // namespace garnet
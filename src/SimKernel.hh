@@ -0,0 +1,148 @@
+// Cycle driver shared by all simulation loops in main.cc.
+//
+// Every cycle wakes the NIs in index order, then the routers, then drains
+// the events due this cycle.  The full-sweep kernel wakes every component
+// every cycle.  The activity-driven kernel only wakes components that have
+// work (see NetworkInterface::get_next_active_time and
+// Router::has_pending_work); skipped wakeups would have been no-ops, so both
+// kernels produce identical results.  When the whole network is quiescent it
+// also jumps straight to the next scheduled event or injection.
+//
+// The phased kernel makes the activity-driven kernel's wakeups, grouped by
+// component type so that each group runs as one loop over objects of a
+// single class.  Each cycle, in this order:
+//   1. NIs with work, in index order;
+//   2. routers with work, in index order: first every router's input
+//      units, then every router's output units, then every switch
+//      allocator, then every crossbar;
+//   3. the events due this cycle, bucketed by type in rank order: NIs,
+//      then routers (again in the four steps of 2.), then output units,
+//      then flit and credit links, then anything else;
+//   4. 3. again while zero-latency links leave events for this cycle.
+// A component only reads what the ones before it in this order wrote this
+// cycle; everything else it reads carries a timestamp of an earlier cycle.
+// The rank-ordered dispatch of the other kernels ends up with the same
+// reads, so the phased kernel gives their results too, except that a
+// zero-latency link may have its consumer woken an extra time.
+//
+// With more than one thread the routers are split into contiguous index
+// blocks, one partition per thread; in a chiplet system a block is a run of
+// whole chiplets (Router::get_chiplet()), so only inter-chiplet links
+// cross.  An NI joins the partition of its (vnet 0) router and every link
+// the partition of the component feeding it.  Each partition has its own
+// event queue and stats; links into another partition park their flits in
+// a lock-free single-producer outbox.  Such a flit cannot arrive before the
+// link's delay has passed (NetworkLink::get_min_delay(): the latency, or a
+// bridge's CDC and serdes delay), so the partitions run windows of the
+// smallest such delay (the lookahead) independently and exchange outboxes
+// at a barrier in between.  Credit links cross too and carry their flit
+// link's latency, so chiplets joined by --inter-latency L links run
+// L-cycle windows, while a mesh split into router blocks runs 1-cycle
+// windows.  Within a cycle, events are dispatched in
+// construction order (see Event), and no two partitions interact inside a
+// window, so the results are identical for every thread count.  Networks
+// with a link that cannot cross partitions run on one thread, with a
+// warning.
+
+#ifndef __GARNET_SIM_KERNEL_HH__
+#define __GARNET_SIM_KERNEL_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "EventQueue.hh"
+#include "GarnetStats.hh"
+#include "SpscQueue.hh"
+
+namespace garnet {
+
+class GarnetNetwork;
+class NetworkInterface;
+class NetworkLink;
+class OutputUnit;
+class Router;
+class flit;
+
+class SimKernel {
+public:
+    enum Mode { FULL_SWEEP, ACTIVITY_DRIVEN, PHASED };
+
+    // Parses a --kernel value ("sweep" / "activity" / "phased"); false if
+    // unknown.
+    static bool parse_mode(const std::string& name, Mode& mode);
+
+    // Uses at most `threads` partitions (one per router at most).  Events
+    // already pending on the network's queue move to the partitions.
+    SimKernel(GarnetNetwork* net, const std::vector<NetworkInterface*>& nis,
+              const std::vector<Router*>& routers, Mode mode,
+              int threads = 1);
+    ~SimKernel();
+
+    // Simulates cycles [start, end).
+    void run(uint64_t start, uint64_t end);
+
+    // Brings every NI's generator up to date with the cycles before `end`
+    // it was skipped for, and hands pending events, stats and wakeup
+    // counters back to the network.  Call once, before reading statistics.
+    void finish(uint64_t end);
+
+    int num_partitions() const { return (int)m_parts.size(); }
+
+private:
+    struct Partition {
+        std::unique_ptr<EventQueue> own_queue;  // null for a single partition
+        EventQueue* queue;
+        GarnetStats stats;
+        std::vector<NetworkInterface*> nis;
+        std::vector<Router*> routers;
+        // Links from other partitions and their outboxes.
+        std::vector<std::pair<NetworkLink*, SpscQueue<flit*>*>> inbound;
+        uint64_t next = 0;                      // first cycle of next window
+
+        // Phased mode: the components to wake in the current phase.
+        std::vector<NetworkInterface*> woken_nis;
+        std::vector<Router*> woken_routers;
+        std::vector<OutputUnit*> woken_output_units;
+        std::vector<NetworkLink*> woken_links;
+        std::vector<GarnetSimObject*> woken_others;
+    };
+
+    void partition(int threads);
+    // Sizes the partition's event wheel for a wakeup of each of its
+    // objects every cycle, and reserves the calling thread FlitPool slots
+    // for every flit, credit and header its buffers can hold, so that
+    // neither allocates once the run is under way.
+    static void reserve(const Partition& part);
+    void run_cycle(Partition& part, uint64_t t);
+    void run_phased_cycle(Partition& part, uint64_t t);
+    static void wake_routers(const std::vector<Router*>& routers);
+    // Next cycle after t at which `part` has work, capped at limit.
+    uint64_t next_cycle(const Partition& part, uint64_t t,
+                        uint64_t limit) const;
+    void run_partition(Partition& part, uint64_t start, uint64_t end);
+    void deliver_inbound(Partition& part);
+    void worker(Partition& part);
+    void barrier();
+
+    GarnetNetwork* m_net;
+    Mode m_mode;
+    std::vector<std::unique_ptr<Partition>> m_parts;
+    std::vector<NetworkLink*> m_remote_links;
+    std::vector<std::unique_ptr<SpscQueue<flit*>>> m_outboxes;
+    uint64_t m_lookahead = (uint64_t)-1;
+
+    std::vector<std::thread> m_workers;
+    uint64_t m_run_start = 0, m_run_end = 0;   // current run() for workers
+    bool m_stop = false;
+    std::atomic<int> m_barrier_waiting{0};
+    std::atomic<uint64_t> m_barrier_generation{0};
+};
+
+} // namespace garnet
+
+#endif // __GARNET_SIM_KERNEL_HH__
@@ -1,14 +1,17 @@
 #ifndef __GARNET_SIMPLE_TRAFFIC_GENERATOR_HH__
 #define __GARNET_SIMPLE_TRAFFIC_GENERATOR_HH__
 
+#include <algorithm>
 #include <queue>
 #include <cstdlib>
 #include <cmath>
 #include <limits>
 #include <iostream>
 #include <random>
+#include "CounterRng.hh"
 #include <vector>
 #include "flit.hh"
+#include "flitBuffer.hh"
 #include "GarnetNetwork.hh"
 #include "NetworkInterface.hh"
 #include "CommonTypes.hh"
@@ -34,7 +37,7 @@ public:
         m_active = true;
         m_packet_size = 1;
         m_trace_packet = false;
-        m_rng.seed(42 + id);
+        seed_streams(42);
         int num_vnets = 2; // Default from Topology
         m_received_per_vnet.resize(num_vnets, 0);
         m_latency_per_vnet.resize(num_vnets, 0);
@@ -46,17 +49,34 @@ public:
     ~SimpleTrafficGenerator()
     {
         if (m_stalled_flit) delete m_stalled_flit;
-        while (!m_flit_queue.empty()) {
-            flit* fl = m_flit_queue.front();
-            m_flit_queue.pop();
-            delete fl;
-        }
+        while (!m_flit_queue.isEmpty()) delete m_flit_queue.getTopFlit();
     }
 
-    void set_injection_rate(double rate) override { m_injection_rate = rate; }
+    void set_injection_rate(double rate) override
+    {
+        m_injection_rate = rate;
+        m_injection_scheduled = false;
+    }
+
+    // Only packets generated in cycles [start, end) are tagged and enter
+    // the injected/received statistics; the default window is the whole
+    // run.  The end may be moved once the window is known.
+    void set_measure_window(uint64_t start, uint64_t end)
+    {
+        m_measure_start = start;
+        m_measure_end = end;
+    }
     void set_packet_size(int size)       override { m_packet_size = size; }
-    void set_active(bool active)         override { m_active = active; }
-    void set_seed(int seed)              override { m_rng.seed(seed + m_id); }
+    void set_active(bool active)         override
+    {
+        m_active = active;
+        m_injection_scheduled = false;
+    }
+    void set_seed(int seed)              override
+    {
+        seed_streams(seed);
+        m_injection_scheduled = false;
+    }
     void set_trace_packet(bool trace)    override { m_trace_packet = trace; }
 
     flit* send_flit() override
@@ -68,18 +88,21 @@ public:
             m_last_injection_cycle = current_time;
             m_injection_attempts++; 
 
-            if (m_active && m_id == 0 && m_flit_queue.empty()) {
+            if (m_active && m_id == 0 && m_flit_queue.isEmpty()) {
                 int dest_id = m_num_nis - 1; // Send to last NI
                 generate_packet(dest_id, 0, current_time, m_trace_packet);
-                m_injected_packets++;
+                if (in_measure_window(current_time)) m_injected_packets++;
             }
             else if (!m_active && m_injection_rate > 0.0) {
-                if (m_dist(m_rng) <= m_injection_rate) {
-                    int dest_id = m_dest_dist(m_rng);
+                if (!m_injection_scheduled)
+                    schedule_next_injection(current_time);
+                if (current_time >= m_next_injection) {
+                    schedule_next_injection(current_time + 1);
+                    int dest_id = m_dest_dist(m_packet_rng);
                     if (dest_id == m_id) dest_id = (dest_id + 1) % m_num_nis;
-                    int vnet = m_vnet_dist(m_rng);
+                    int vnet = m_vnet_dist(m_packet_rng);
                     generate_packet(dest_id, vnet, current_time);
-                    m_injected_packets++;
+                    if (in_measure_window(current_time)) m_injected_packets++;
                 }
             }
         }
@@ -92,9 +115,8 @@ public:
             return fl;
         }
 
-        if (!m_flit_queue.empty()) {
-            flit* head = m_flit_queue.front();
-            m_flit_queue.pop();
+        if (!m_flit_queue.isEmpty()) {
+            flit* head = m_flit_queue.getTopFlit();
             head->set_enqueue_time(current_time);
             return head;
         }
@@ -105,7 +127,8 @@ public:
 
     void receive_flit(flit* flt) override {
         uint64_t current_time = m_net_ptr->getEventQueue()->get_current_time();
-        if (flt->get_type() == TAIL_ || flt->get_type() == HEAD_TAIL_) {
+        if (flt->is_measured() &&
+            (flt->get_type() == TAIL_ || flt->get_type() == HEAD_TAIL_)) {
             uint64_t latency = current_time - flt->get_enqueue_time();
             m_total_latency += latency;
             m_received_packets++;
@@ -129,10 +152,106 @@ public:
 
     const LatHist& get_lat_hist() const override { return m_lat_hist; }
 
-    void schedule_next_injection(uint64_t) override {}
-    uint64_t get_next_injection_time() const override { return 0; }
+    // Starts a new measurement: clears the statistics above, keeps the
+    // packets queued or in flight.
+    void reset_stats()
+    {
+        m_lat_hist = LatHist();
+        m_total_latency = 0;
+        m_received_packets = 0;
+        m_injected_packets = 0;
+        m_injection_attempts = 0;
+        std::fill(m_received_per_vnet.begin(), m_received_per_vnet.end(), 0);
+        std::fill(m_latency_per_vnet.begin(), m_latency_per_vnet.end(), 0);
+    }
+
+    // Draws the next injection cycle at or after `from` from the geometric
+    // inter-arrival distribution of per-cycle Bernoulli(injection rate)
+    // trials.  Redrawn after every injection, and at the next send_flit()
+    // once the rate, seed or mode changes.
+    void schedule_next_injection(uint64_t from) override
+    {
+        m_next_injection =
+            after(from, geometric_gap(m_injection_rate, m_dist(m_injection_rng)));
+        m_injection_scheduled = true;
+    }
+
+    void saveState(CheckpointOut& cp) const override
+    {
+        cp.put(m_injection_rate);
+        cp.put(m_packet_size);
+        cp.put(m_active);
+        cp.put(m_trace_packet);
+        cp.put(m_last_injection_cycle);
+        cp.put(m_next_injection);
+        cp.put(m_injection_scheduled);
+        cp.put(m_measure_start);
+        cp.put(m_measure_end);
+        m_flit_queue.saveState(cp);
+        cp.putFlit(m_stalled_flit);
+        cp.put(m_lat_hist);
+        cp.put(m_total_latency);
+        cp.put(m_received_packets);
+        cp.put(m_injected_packets);
+        cp.put(m_injection_attempts);
+        cp.put(m_received_per_vnet);
+        cp.put(m_latency_per_vnet);
+        cp.put(m_injection_rng);
+        cp.put(m_packet_rng);
+    }
+
+    void loadState(CheckpointIn& cp) override
+    {
+        cp.get(m_injection_rate);
+        cp.get(m_packet_size);
+        cp.get(m_active);
+        cp.get(m_trace_packet);
+        cp.get(m_last_injection_cycle);
+        cp.get(m_next_injection);
+        cp.get(m_injection_scheduled);
+        cp.get(m_measure_start);
+        cp.get(m_measure_end);
+        m_flit_queue.loadState(cp);
+        delete m_stalled_flit;
+        m_stalled_flit = cp.getFlit();
+        cp.get(m_lat_hist);
+        cp.get(m_total_latency);
+        cp.get(m_received_packets);
+        cp.get(m_injected_packets);
+        cp.get(m_injection_attempts);
+        cp.get(m_received_per_vnet);
+        cp.get(m_latency_per_vnet);
+        cp.get(m_injection_rng);
+        cp.get(m_packet_rng);
+    }
+
+    uint64_t get_next_injection_time() const override
+    {
+        uint64_t now = m_net_ptr->getEventQueue()->get_current_time();
+        if (m_stalled_flit || !m_flit_queue.isEmpty() || (m_active && m_id == 0))
+            return now;
+        if (!m_active && m_injection_rate > 0.0)
+            return m_injection_scheduled ? m_next_injection : now;
+        return (uint64_t)-1;
+    }
+
+    void skip_idle_cycles(uint64_t cycles) override
+    {
+        m_injection_attempts += cycles;
+    }
 
 private:
+    void seed_streams(int seed)
+    {
+        m_injection_rng.seed(seed, m_id, INJECTION_STREAM);
+        m_packet_rng.seed(seed, m_id, PACKET_STREAM);
+    }
+
+    bool in_measure_window(uint64_t time) const
+    {
+        return time >= m_measure_start && time < m_measure_end;
+    }
+
     void generate_packet(int dest_id, int vnet, uint64_t time, bool trace = false) {
         if (!m_ni) {
             std::cerr << "Error: m_ni is null in SimpleTrafficGenerator " << m_id << std::endl;
@@ -147,20 +266,20 @@ private:
                       << " for NI " << dest_id << " at time " << time << std::endl;
         }
 
-        RouteInfo route;
-        route.src_ni = m_id;
-        route.dest_ni = dest_id;
-        route.src_router = m_ni->get_router_id(vnet);
-        route.dest_router = m_net_ptr->get_router_id(dest_id, vnet); 
-        route.vnet = vnet;
-        route.net_dest.add(dest_id);
-
-        for (int i = 0; i < packet_size; i++) {
-            flit* fl = new flit(packet_id, i, 0, vnet, route, packet_size,
-                                nullptr, 0, ni_flit_size, time);
-            fl->set_trace(trace);
-            m_flit_queue.push(fl);
-        }
+        PacketHeader* pkt = new PacketHeader;
+        pkt->route.src_ni = m_id;
+        pkt->route.dest_ni = dest_id;
+        pkt->route.src_router = m_ni->get_router_id(vnet);
+        pkt->route.dest_router = m_net_ptr->get_router_id(dest_id, vnet); 
+        pkt->route.vnet = vnet;
+        pkt->packet_id = packet_id;
+        pkt->creation_time = time;
+        pkt->trace = trace;
+        pkt->measured = in_measure_window(time);
+
+        for (int i = 0; i < packet_size; i++)
+            m_flit_queue.insert(new flit(pkt, i, 0, vnet, packet_size,
+                                       ni_flit_size, time));
     }
 
     int m_id;
@@ -169,11 +288,16 @@ private:
     int m_packet_size = 1;
     GarnetNetwork* m_net_ptr;
     NetworkInterface* m_ni;
-    std::queue<flit*> m_flit_queue; 
+    flitBuffer m_flit_queue; 
     flit* m_stalled_flit;
     bool m_active; 
     bool m_trace_packet = false;
     uint64_t m_last_injection_cycle;
+    // Cycle of the next random packet; redrawn when !m_injection_scheduled.
+    uint64_t m_next_injection = (uint64_t)-1;
+    bool m_injection_scheduled = false;
+    uint64_t m_measure_start = 0;
+    uint64_t m_measure_end = (uint64_t)-1;
 
     LatHist  m_lat_hist;
     uint64_t m_total_latency;
@@ -184,7 +308,8 @@ private:
     std::vector<uint64_t> m_received_per_vnet;
     std::vector<uint64_t> m_latency_per_vnet;
 
-    std::mt19937 m_rng;
+    CounterRng m_injection_rng;
+    CounterRng m_packet_rng;
     std::uniform_real_distribution<double> m_dist;
     std::uniform_int_distribution<int> m_dest_dist;
     std::uniform_int_distribution<int> m_vnet_dist;
@@ -0,0 +1,58 @@
+// Bounded lock-free single-producer / single-consumer ring.
+//
+// Used by SimKernel for links whose two ends are simulated by different
+// threads: the producer's thread pushes, the consumer's thread pops.
+
+#ifndef __GARNET_SPSC_QUEUE_HH__
+#define __GARNET_SPSC_QUEUE_HH__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace garnet {
+
+template <typename T>
+class SpscQueue {
+public:
+    // Rounded up to a power of two.
+    explicit SpscQueue(size_t capacity)
+    {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        m_items.resize(n);
+        m_mask = n - 1;
+    }
+
+    // False if the ring is full.
+    bool push(const T& item)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+            return false;
+        m_items[tail & m_mask] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // False if the ring is empty.
+    bool pop(T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+        item = m_items[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> m_items;
+    size_t m_mask;
+    std::atomic<size_t> m_head{0};
+    std::atomic<size_t> m_tail{0};
+};
+
+} // namespace garnet
+
+#endif // __GARNET_SPSC_QUEUE_HH__
@@ -14,6 +14,7 @@
 #define __STANDALONE_STATS_HH__
 
 #include <array>
+#include <cmath>
 #include <cstdint>
 
 namespace garnet {
@@ -80,6 +81,37 @@ struct LatHist {
     }
 };
 
+// Mean and 95% confidence interval of independent replications (e.g. the
+// seeds of one sweep point), using Student's t for small sample counts.
+struct SampleStats {
+    uint64_t n = 0;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+
+    void add(double x) { ++n; sum += x; sum_sq += x * x; }
+
+    double mean() const { return n > 0 ? sum / n : 0.0; }
+
+    double stddev() const {
+        if (n < 2) return 0.0;
+        double var = (sum_sq - sum * sum / n) / (n - 1);
+        return var > 0.0 ? std::sqrt(var) : 0.0;
+    }
+
+    // Half-width of the 95% interval around mean().
+    double ci95() const {
+        if (n < 2) return 0.0;
+        static const double t975[] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+            2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+            2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+            2.048, 2.045, 2.042 };
+        uint64_t dof = n - 1;
+        double t = dof <= 30 ? t975[dof - 1] : 1.960;
+        return t * stddev() / std::sqrt((double)n);
+    }
+};
+
 } // namespace garnet
 
 #endif // __STANDALONE_STATS_HH__
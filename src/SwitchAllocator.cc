@@ -35,15 +35,42 @@
 #include "InputUnit.hh"
 #include "OutputUnit.hh"
 #include "Router.hh"
+#include "RouterKernel.hh"
 
 namespace garnet
 {
 
+namespace
+{
+
+// BitMask::find_from(); the fixed-size kernels scan a single word.
+template <int Ports, typename F>
+inline int
+find_from(const BitMask& mask, int start, F f)
+{
+    return Ports ? mask.find_from_word(start, f) : mask.find_from(start, f);
+}
+
+} // namespace
+
+struct SwitchAllocator::Kernels
+{
+    typedef void (SwitchAllocator::*Kernel)();
+
+    template <int Ports, int VcsPerVnet>
+    static Kernel
+    get()
+    {
+        return &SwitchAllocator::allocate<Ports, VcsPerVnet>;
+    }
+};
+
 SwitchAllocator::SwitchAllocator(Router *router)
 {
     m_router = router;
     m_num_vcs = m_router->get_num_vcs();
     m_vc_per_vnet = m_router->get_vc_per_vnet();
+    m_kernel = &SwitchAllocator::allocate<0, 0>;
 }
 
 void
@@ -55,6 +82,15 @@ SwitchAllocator::init()
     m_round_robin_invc.resize(m_num_inports);
     m_port_requests.resize(m_num_inports);
     m_vc_winners.resize(m_num_inports);
+    m_outport_requests.assign(m_num_outports, BitMask(m_num_inports));
+    m_requested_outports.resize(m_num_outports);
+
+    m_input_units.clear();
+    for (int i = 0; i < m_num_inports; i++)
+        m_input_units.push_back(m_router->getInputUnit(i));
+    m_output_units.clear();
+    for (int i = 0; i < m_num_outports; i++)
+        m_output_units.push_back(m_router->getOutputUnit(i));
 
     for (int i = 0; i < m_num_inports; i++) {
         m_round_robin_invc[i] = 0;
@@ -65,6 +101,8 @@ SwitchAllocator::init()
     for (int i = 0; i < m_num_outports; i++) {
         m_round_robin_inport[i] = 0;
     }
+
+    m_kernel = selectRouterKernel<Kernels>(m_router->get_shape());
 }
 
 /*
@@ -79,11 +117,19 @@ SwitchAllocator::init()
 void
 SwitchAllocator::wakeup()
 {
-    arbitrate_inports(); // First stage of allocation
-    arbitrate_outports(); // Second stage of allocation
+    (this->*m_kernel)();
+}
+
+template <int Ports, int VcsPerVnet>
+void
+SwitchAllocator::allocate()
+{
+    m_time = m_router->get_net_ptr()->getEventQueue()->get_current_time();
+    arbitrate_inports<Ports, VcsPerVnet>(); // First stage of allocation
+    arbitrate_outports<Ports, VcsPerVnet>(); // Second stage of allocation
 
     clear_request_vector();
-    check_for_wakeup();
+    check_for_wakeup<Ports, VcsPerVnet>();
 }
 
 /*
@@ -96,41 +142,38 @@ SwitchAllocator::wakeup()
  * Places a request for the output port from this input VC.
  */
 
+template <int Ports, int VcsPerVnet>
 void
 SwitchAllocator::arbitrate_inports()
 {
-    // Select a VC from each input in a round robin manner
-    // Independent arbiter at each input port
-    for (int inport = 0; inport < m_num_inports; inport++) {
-        int invc = m_round_robin_invc[inport];
-
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
-            auto input_unit = m_router->getInputUnit(inport);
+    const int num_inports = Ports ? Ports : m_num_inports;
 
-            uint64_t current_time = m_router->get_net_ptr()->getEventQueue()->get_current_time();
-            if (input_unit->need_stage(invc, SA_, current_time)) {
-                // This flit is in SA stage
-
-                int outport = input_unit->get_outport(invc);
-                int outvc = input_unit->get_outvc(invc);
-
-                // check if the flit in this InputVC is allowed to be sent
-                // send_allowed conditions described in that function.
-                bool make_request =
-                    send_allowed(inport, invc, outport, outvc);
+    // Select a VC from each input in a round robin manner
+    // Independent arbiter at each input port.  Only VCs holding a flit
+    // can be in SA stage.
+    for (int inport = 0; inport < num_inports; inport++) {
+        InputUnit *input_unit = m_input_units[inport];
+        find_from<Ports>(input_unit->occupied_vcs(),
+                         m_round_robin_invc[inport], [&](int invc) {
+            if (!input_unit->need_stage(invc, SA_, m_time))
+                return false;
 
-                if (make_request) {
-                    m_port_requests[inport] = outport;
-                    m_vc_winners[inport] = invc;
+            // This flit is in SA stage
+            int outport = input_unit->get_outport(invc);
+            int outvc = input_unit->get_outvc(invc);
 
-                    break; // got one vc winner for this port
-                }
-            }
+            // check if the flit in this InputVC is allowed to be sent
+            // send_allowed conditions described in that function.
+            if (!send_allowed<Ports, VcsPerVnet>(inport, invc, outport,
+                                                 outvc))
+                return false;
 
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
-        }
+            m_port_requests[inport] = outport;
+            m_vc_winners[inport] = invc;
+            m_outport_requests[outport].set(inport);
+            m_requested_outports.set(outport);
+            return true; // got one vc winner for this port
+        });
     }
 }
 
@@ -148,96 +191,89 @@ SwitchAllocator::arbitrate_inports()
  * credit is set to true.
  */
 
+template <int Ports, int VcsPerVnet>
 void
 SwitchAllocator::arbitrate_outports()
 {
+    const int num_inports = Ports ? Ports : m_num_inports;
+
     // Now there are a set of input vc requests for output vcs.
     // Again do round robin arbitration on these requests
     // Independent arbiter at each output port
-    for (int outport = 0; outport < m_num_outports; outport++) {
-        int inport = m_round_robin_inport[outport];
-
-        for (int inport_iter = 0; inport_iter < m_num_inports;
-                 inport_iter++) {
-
-            // inport has a request this cycle for outport
-            if (m_port_requests[inport] == outport) {
-                auto output_unit = m_router->getOutputUnit(outport);
-                auto input_unit = m_router->getInputUnit(inport);
-
-                // grant this outport to this inport
-                int invc = m_vc_winners[inport];
-
-                int outvc = input_unit->get_outvc(invc);
-                if (outvc == -1) {
-                    // VC Allocation - select any free VC from outport
-                    outvc = vc_allocate(outport, inport, invc);
-                }
-
-                // remove flit from Input VC
-                flit *t_flit = input_unit->getTopFlit(invc);
-
-                // Update outport field in the flit since this is
-                // used by CrossbarSwitch code to send it out of
-                // correct outport.
-                // Note: post route compute in InputUnit,
-                // outport is updated in VC, but not in flit
-                t_flit->set_outport(outport);
-
-                // set outvc (i.e., invc for next hop) in flit
-                // (This was updated in VC by vc_allocate, but not in flit)
-                t_flit->set_vc(outvc);
-
-                // decrement credit in outvc
-                output_unit->decrement_credit(outvc);
-
-                uint64_t current_time = m_router->get_net_ptr()->getEventQueue()->get_current_time();
-                // flit ready for Switch Traversal
-                t_flit->advance_stage(ST_, current_time);
-                m_router->grant_switch(inport, t_flit);
-
-                if ((t_flit->get_type() == TAIL_) ||
-                    (t_flit->get_type() == HEAD_TAIL_)) {
-
-                    // This Input VC should now be empty
-                    assert(!(input_unit->isReady(invc, current_time)));
-
-                    // Free this VC
-                    input_unit->set_vc_idle(invc, current_time);
-
-                    // Send a credit back
-                    // along with the information that this VC is now idle
-                    input_unit->increment_credit(invc, true, current_time);
-                } else {
-                    // Send a credit back
-                    // but do not indicate that the VC is idle
-                    input_unit->increment_credit(invc, false, current_time);
-                }
-
-                // remove this request
-                m_port_requests[inport] = -1;
-
-                // Update Round Robin pointer
-                m_round_robin_inport[outport] = inport + 1;
-                if (m_round_robin_inport[outport] >= m_num_inports)
-                    m_round_robin_inport[outport] = 0;
-
-                // Update Round Robin pointer to the next VC
-                // We do it here to keep it fair.
-                // Only the VC which got switch traversal
-                // is updated.
-                m_round_robin_invc[inport] = invc + 1;
-                if (m_round_robin_invc[inport] >= m_num_vcs)
-                    m_round_robin_invc[inport] = 0;
-
-
-                break; // got a input winner for this outport
-            }
+    for (int outport = m_requested_outports.find_next(0); outport != -1;
+         outport = m_requested_outports.find_next(outport + 1)) {
+        // first inport with a request this cycle for outport
+        int inport = find_from<Ports>(m_outport_requests[outport],
+                                      m_round_robin_inport[outport],
+                                      [](int) { return true; });
+
+        OutputUnit *output_unit = m_output_units[outport];
+        InputUnit *input_unit = m_input_units[inport];
+
+        // grant this outport to this inport
+        int invc = m_vc_winners[inport];
+
+        int outvc = input_unit->get_outvc(invc);
+        if (outvc == -1) {
+            // VC Allocation - select any free VC from outport
+            outvc = vc_allocate(outport, inport, invc);
+        }
+
+        // remove flit from Input VC
+        flit *t_flit = input_unit->getTopFlit(invc);
+        m_router->decrement_buffered_flits();
+
+        // Update outport field in the flit since this is
+        // used by CrossbarSwitch code to send it out of
+        // correct outport.
+        // Note: post route compute in InputUnit,
+        // outport is updated in VC, but not in flit
+        t_flit->set_outport(outport);
+
+        // set outvc (i.e., invc for next hop) in flit
+        // (This was updated in VC by vc_allocate, but not in flit)
+        t_flit->set_vc(outvc);
+
+        // decrement credit in outvc
+        output_unit->decrement_credit(outvc);
+
+        // flit ready for Switch Traversal
+        t_flit->advance_stage(ST_, m_time);
+        m_router->grant_switch(inport, t_flit);
+
+        if ((t_flit->get_type() == TAIL_) ||
+            (t_flit->get_type() == HEAD_TAIL_)) {
+
+            // This Input VC should now be empty
+            assert(!(input_unit->isReady(invc, m_time)));
+
+            // Free this VC
+            input_unit->set_vc_idle(invc, m_time);
 
-            inport++;
-            if (inport >= m_num_inports)
-                inport = 0;
+            // Send a credit back
+            // along with the information that this VC is now idle
+            input_unit->increment_credit(invc, true, m_time);
+        } else {
+            // Send a credit back
+            // but do not indicate that the VC is idle
+            input_unit->increment_credit(invc, false, m_time);
         }
+
+        // remove this request
+        m_port_requests[inport] = -1;
+
+        // Update Round Robin pointer
+        m_round_robin_inport[outport] = inport + 1;
+        if (m_round_robin_inport[outport] >= num_inports)
+            m_round_robin_inport[outport] = 0;
+
+        // Update Round Robin pointer to the next VC
+        // We do it here to keep it fair.
+        // Only the VC which got switch traversal
+        // is updated.
+        m_round_robin_invc[inport] = invc + 1;
+        if (m_round_robin_invc[inport] >= m_num_vcs)
+            m_round_robin_invc[inport] = 0;
     }
 }
 
@@ -255,6 +291,7 @@ SwitchAllocator::arbitrate_outports()
  *     that arrived before this flit and is requesting the same output port.
  */
 
+template <int Ports, int VcsPerVnet>
 bool
 SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
 {
@@ -262,11 +299,11 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
     // Check if credit needed (for multi-flit packet)
     // Check if ordering violated (in ordered vnet)
 
-    int vnet = get_vnet(invc);
+    int vnet = invc / (VcsPerVnet ? VcsPerVnet : m_vc_per_vnet);
     bool has_outvc = (outvc != -1);
     bool has_credit = false;
 
-    auto output_unit = m_router->getOutputUnit(outport);
+    OutputUnit *output_unit = m_output_units[outport];
     if (!has_outvc) {
 
         // needs outvc
@@ -291,18 +328,17 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
 
     // protocol ordering check
     if ((m_router->get_net_ptr())->isVNetOrdered(vnet)) {
-        auto input_unit = m_router->getInputUnit(inport);
+        InputUnit *input_unit = m_input_units[inport];
 
         // enqueue time of this flit
         uint64_t t_enqueue_time = input_unit->get_enqueue_time(invc);
 
-        // check if any other flit is ready for SA and for same output port
-        // and was enqueued before this flit
-        int vc_base = vnet*m_vc_per_vnet;
-        for (int vc_offset = 0; vc_offset < m_vc_per_vnet; vc_offset++) {
-            int temp_vc = vc_base + vc_offset;
-            if (input_unit->need_stage(temp_vc, SA_, m_router->get_net_ptr()->getEventQueue()->get_current_time()) &&
-               (input_unit->get_outport(temp_vc) == outport) &&
+        // check if any packet that arrived before this one for the same
+        // output port is ready for SA; the input unit keeps them in
+        // arrival order, so the head of the queue goes straight through
+        for (int temp_vc = input_unit->get_older_vc(invc); temp_vc != -1;
+             temp_vc = input_unit->get_older_vc(temp_vc)) {
+            if (input_unit->need_stage(temp_vc, SA_, m_time) &&
                (input_unit->get_enqueue_time(temp_vc) < t_enqueue_time)) {
                 return false;
             }
@@ -317,28 +353,31 @@ int
 SwitchAllocator::vc_allocate(int outport, int inport, int invc)
 {
     // Select a free VC from the output port
-    int outvc =
-        m_router->getOutputUnit(outport)->select_free_vc(get_vnet(invc));
+    int outvc = m_output_units[outport]->select_free_vc(get_vnet(invc));
 
     // has to get a valid VC since it checked before performing SA
     assert(outvc != -1);
-    m_router->getInputUnit(inport)->grant_outvc(invc, outvc);
+    m_input_units[inport]->grant_outvc(invc, outvc);
     return outvc;
 }
 
 // Wakeup the router next cycle to perform SA again
 // if there are flits ready.
+template <int Ports, int VcsPerVnet>
 void
 SwitchAllocator::check_for_wakeup()
 {
-    uint64_t nextCycle = m_router->get_net_ptr()->getEventQueue()->get_current_time() + 1;
-
-    for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
-            if (m_router->getInputUnit(i)->need_stage(j, SA_, nextCycle)) {
-                m_router->get_net_ptr()->getEventQueue()->schedule(m_router, 1);
-                return;
-            }
+    const int num_inports = Ports ? Ports : m_num_inports;
+    uint64_t nextCycle = m_time + 1;
+
+    for (int inport = 0; inport < num_inports; inport++) {
+        InputUnit *input_unit = m_input_units[inport];
+        int vc = find_from<Ports>(input_unit->occupied_vcs(), 0, [&](int j) {
+            return input_unit->need_stage(j, SA_, nextCycle);
+        });
+        if (vc != -1) {
+            m_router->get_net_ptr()->getEventQueue()->schedule(m_router, 1);
+            return;
         }
     }
 }
@@ -358,6 +397,30 @@ void
 SwitchAllocator::clear_request_vector()
 {
     std::fill(m_port_requests.begin(), m_port_requests.end(), -1);
+    for (int outport = m_requested_outports.find_next(0); outport != -1;
+         outport = m_requested_outports.find_next(outport + 1))
+        m_outport_requests[outport].clear();
+    m_requested_outports.clear();
+}
+
+void
+SwitchAllocator::saveState(CheckpointOut& cp) const
+{
+    GarnetSimObject::saveState(cp);
+    cp.put(m_round_robin_invc);
+    cp.put(m_round_robin_inport);
+    cp.put(m_port_requests);
+    cp.put(m_vc_winners);
+}
+
+void
+SwitchAllocator::loadState(CheckpointIn& cp)
+{
+    GarnetSimObject::loadState(cp);
+    cp.get(m_round_robin_invc);
+    cp.get(m_round_robin_inport);
+    cp.get(m_port_requests);
+    cp.get(m_vc_winners);
 }
 
 } // namespace garnet
@@ -35,6 +35,7 @@
 #include <iostream>
 #include <vector>
 
+#include "BitMask.hh"
 #include "CommonTypes.hh"
 #include "GarnetSimObject.hh"
 
@@ -49,26 +50,42 @@ class SwitchAllocator : public GarnetSimObject
 {
   public:
     SwitchAllocator(Router *router);
-    void wakeup();
+    void wakeup() final;
     void init();
     void clear_request_vector();
-    void check_for_wakeup();
     int get_vnet (int invc);
     void print(std::ostream& out) const {};
-    void arbitrate_inports();
-    void arbitrate_outports();
-    bool send_allowed(int inport, int invc, int outport, int outvc);
+    void saveState(CheckpointOut& cp) const override;
+    void loadState(CheckpointIn& cp) override;
     int vc_allocate(int outport, int inport, int invc);
 
   private:
+    // One allocation cycle and its stages, instantiated per router shape
+    // (see RouterKernel.hh); <0, 0> works for any router.
+    template <int Ports, int VcsPerVnet> void allocate();
+    template <int Ports, int VcsPerVnet> void arbitrate_inports();
+    template <int Ports, int VcsPerVnet> void arbitrate_outports();
+    template <int Ports, int VcsPerVnet>
+    bool send_allowed(int inport, int invc, int outport, int outvc);
+    template <int Ports, int VcsPerVnet> void check_for_wakeup();
+    struct Kernels;
+
     int m_num_inports, m_num_outports;
     int m_num_vcs, m_vc_per_vnet;
 
     Router *m_router;
+    void (SwitchAllocator::*m_kernel)();
+    std::vector<InputUnit*> m_input_units;
+    std::vector<OutputUnit*> m_output_units;
+    uint64_t m_time = 0;                       // cycle of this wakeup
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
     std::vector<int> m_port_requests;
     std::vector<int> m_vc_winners;
+    // Inports requesting each outport this cycle, and the outports
+    // requested at all.
+    std::vector<BitMask> m_outport_requests;
+    BitMask m_requested_outports;
 };
 
 } // namespace garnet
@@ -21,9 +21,44 @@ Topology::~Topology()
 {
     for (auto p : m_tgs)          delete p;
     for (auto p : m_nis)          delete p;
+    // Links live in their routers' arenas.
     for (auto p : m_routers)      delete p;
-    for (auto p : m_links)        delete p;
-    for (auto p : m_credit_links) delete p;
+}
+
+size_t Topology::getRouterBytes() const
+{
+    size_t bytes = 0;
+    for (auto router : m_routers) bytes += router->getStateBytes();
+    return bytes;
+}
+
+std::vector<GarnetSimObject*> Topology::getSimObjects() const
+{
+    std::vector<GarnetSimObject*> objects;
+    for (auto router : m_routers) router->getSimObjects(objects);
+    objects.insert(objects.end(), m_nis.begin(), m_nis.end());
+    objects.insert(objects.end(), m_links.begin(), m_links.end());
+    objects.insert(objects.end(), m_credit_links.begin(), m_credit_links.end());
+    return objects;
+}
+
+void Topology::saveState(CheckpointOut& cp) const
+{
+    std::vector<GarnetSimObject*> objects = getSimObjects();
+    cp.setObjects(objects);
+    for (auto obj : objects) obj->saveState(cp);
+    m_net->saveState(cp);
+}
+
+void Topology::loadState(CheckpointIn& cp)
+{
+    std::vector<GarnetSimObject*> objects = getSimObjects();
+    cp.setObjects(objects);
+    for (auto obj : objects) {
+        if (!cp.ok()) return;
+        obj->loadState(cp);
+    }
+    m_net->loadState(cp);
 }
 
 Topology* Topology::create(std::string name, GarnetNetwork* net,
@@ -95,34 +130,41 @@ void Topology::connectRouters(int src, int dest, int link_id_base,
     link_p.latency = latency;
     link_p.virtual_networks = m_num_vns;
     link_p.net_ptr = m_net;
-    NetworkLink* link = new NetworkLink(link_p);
+    // Both links serve dest's inport and live next to it.
+    Arena& arena = m_routers[dest]->getArena();
+    NetworkLink* link = arena.create<NetworkLink>(link_p);
     m_links.push_back(link);
 
     CreditLink::Params credit_p;
     credit_p.id = link_id_base + 1;
-    credit_p.latency = 1;
+    credit_p.latency = latency;
     credit_p.virtual_networks = m_num_vns;
     credit_p.net_ptr = m_net;
-    CreditLink* credit_link = new CreditLink(credit_p);
+    CreditLink* credit_link = arena.create<CreditLink>(credit_p);
     m_credit_links.push_back(credit_link);
 
     std::vector<NetDest> routing_table_entry(m_num_vns);
 
-    m_routers[src]->addOutPort(src_out_dir, link, routing_table_entry,
-                               1, credit_link, m_vcs_per_vnet);
-    m_routers[dest]->addInPort(dest_in_dir, link, credit_link);
+    m_routers[src]->addOutPort(internPortDirection(src_out_dir), link,
+                               routing_table_entry, 1, credit_link,
+                               m_vcs_per_vnet);
+    m_routers[dest]->addInPort(internPortDirection(dest_in_dir), link,
+                               credit_link);
 }
 
 void Topology::connectNiToRouter(int ni_id, int router_id, int link_id_base,
                                  const std::string& local_dir)
 {
+    // All four links live next to the router.
+    Arena& arena = m_routers[router_id]->getArena();
+
     // NI -> Router
     NetworkLink::Params l1_p;
     l1_p.id = link_id_base;
     l1_p.latency = 1;
     l1_p.virtual_networks = m_num_vns;
     l1_p.net_ptr = m_net;
-    NetworkLink* ni_to_r = new NetworkLink(l1_p);
+    NetworkLink* ni_to_r = arena.create<NetworkLink>(l1_p);
     m_links.push_back(ni_to_r);
 
     CreditLink::Params c1_p;
@@ -130,11 +172,12 @@ void Topology::connectNiToRouter(int ni_id, int router_id, int link_id_base,
     c1_p.latency = 1;
     c1_p.virtual_networks = m_num_vns;
     c1_p.net_ptr = m_net;
-    CreditLink* r_to_ni_credit = new CreditLink(c1_p);
+    CreditLink* r_to_ni_credit = arena.create<CreditLink>(c1_p);
     m_credit_links.push_back(r_to_ni_credit);
 
     m_nis[ni_id]->addOutPort(ni_to_r, r_to_ni_credit, router_id, m_vcs_per_vnet);
-    m_routers[router_id]->addInPort(local_dir, ni_to_r, r_to_ni_credit);
+    PortDirection local_dirn = internPortDirection(local_dir);
+    m_routers[router_id]->addInPort(local_dirn, ni_to_r, r_to_ni_credit);
 
     // Router -> NI
     NetworkLink::Params l2_p;
@@ -142,7 +185,7 @@ void Topology::connectNiToRouter(int ni_id, int router_id, int link_id_base,
     l2_p.latency = 1;
     l2_p.virtual_networks = m_num_vns;
     l2_p.net_ptr = m_net;
-    NetworkLink* r_to_ni = new NetworkLink(l2_p);
+    NetworkLink* r_to_ni = arena.create<NetworkLink>(l2_p);
     m_links.push_back(r_to_ni);
 
     CreditLink::Params c2_p;
@@ -150,11 +193,11 @@ void Topology::connectNiToRouter(int ni_id, int router_id, int link_id_base,
     c2_p.latency = 1;
     c2_p.virtual_networks = m_num_vns;
     c2_p.net_ptr = m_net;
-    CreditLink* ni_to_r_credit = new CreditLink(c2_p);
+    CreditLink* ni_to_r_credit = arena.create<CreditLink>(c2_p);
     m_credit_links.push_back(ni_to_r_credit);
 
     std::vector<NetDest> routing_table_entry(m_num_vns);
-    m_routers[router_id]->addOutPort(local_dir, r_to_ni, routing_table_entry,
+    m_routers[router_id]->addOutPort(local_dirn, r_to_ni, routing_table_entry,
                                      1, ni_to_r_credit, m_vcs_per_vnet);
     m_nis[ni_id]->addInPort(r_to_ni, ni_to_r_credit);
 }
@@ -236,11 +279,11 @@ void MeshTopology::build()
             int dx = dest_ni % m_cols;
             int dy = dest_ni / m_cols;
 
-            std::string dir = "Local";
-            if (dx > my_x)       dir = "East";
-            else if (dx < my_x)  dir = "West";
-            else if (dy > my_y)  dir = "South";
-            else if (dy < my_y)  dir = "North";
+            PortDirection dir = LOCAL_DIRN_;
+            if (dx > my_x)       dir = EAST_DIRN_;
+            else if (dx < my_x)  dir = WEST_DIRN_;
+            else if (dy > my_y)  dir = SOUTH_DIRN_;
+            else if (dy < my_y)  dir = NORTH_DIRN_;
 
             int port = router->getOutportIndex(dir);
             if (port != -1) router->addRouteForPort(port, dest_ni);
@@ -297,6 +340,7 @@ void ChipletTopology::build()
 
         Router::Params rp;
         rp.id = r; rp.x = gx; rp.y = gy; rp.z = 0;
+        rp.chiplet = chiplet;
         rp.virtual_networks = m_num_vns;
         rp.vcs_per_vnet     = m_vcs_per_vnet;
         rp.network_ptr      = m_net;
@@ -490,10 +534,12 @@ void ChipletTopology::build()
                 std::string local_dir = (concentration > 1)
                                         ? "Local_" + std::to_string(dest_ni % concentration)
                                         : "Local";
-                int port = m_routers[src]->getOutportIndex(local_dir);
+                int port = m_routers[src]->getOutportIndex(
+                    internPortDirection(local_dir));
                 if (port >= 0) m_routers[src]->addRouteForPort(port, dest_ni);
             } else if (!first_hop[dest_router].empty()) {
-                int port = m_routers[src]->getOutportIndex(first_hop[dest_router]);
+                int port = m_routers[src]->getOutportIndex(
+                    internPortDirection(first_hop[dest_router]));
                 if (port >= 0) m_routers[src]->addRouteForPort(port, dest_ni);
             } else {
                 std::cerr << "ChipletTopology: WARNING: no route from router "
@@ -559,19 +605,22 @@ void StarTopology::build()
         for (int dest_ni = 0; dest_ni < num_routers; ++dest_ni) {
             int dest_router = dest_ni;
             if (src == dest_router) {
-                int port = m_routers[src]->getOutportIndex("Local");
+                int port = m_routers[src]->getOutportIndex(LOCAL_DIRN_);
                 m_routers[src]->addRouteForPort(port, dest_ni);
             } else if (src == 0) {
                 // center -> leaf
-                int port = m_routers[src]->getOutportIndex("ToLeaf" + std::to_string(dest_router));
+                int port = m_routers[src]->getOutportIndex(
+                    internPortDirection("ToLeaf" + std::to_string(dest_router)));
                 m_routers[src]->addRouteForPort(port, dest_ni);
             } else if (dest_router == 0) {
                 // leaf -> center
-                int port = m_routers[src]->getOutportIndex("ToCenter");
+                int port = m_routers[src]->getOutportIndex(
+                    internPortDirection("ToCenter"));
                 m_routers[src]->addRouteForPort(port, dest_ni);
             } else {
                 // leaf -> center -> leaf
-                int port = m_routers[src]->getOutportIndex("ToCenter");
+                int port = m_routers[src]->getOutportIndex(
+                    internPortDirection("ToCenter"));
                 m_routers[src]->addRouteForPort(port, dest_ni);
             }
         }
@@ -40,8 +40,21 @@ public:
     const std::vector<SimpleTrafficGenerator*>& getTGs() const { return m_tgs; }
     const std::vector<NetworkLink*>& getLinks() const { return m_links; }
 
+    // Memory of all routers: the Router objects and their arenas, which
+    // hold their units, VCs, crossbar buffers and incoming links.
+    size_t getRouterBytes() const;
+
     virtual int get_diameter() const = 0;
 
+    // Every simulated object in the network, in a fixed order: routers with
+    // their units, NIs, flit links, credit links.
+    std::vector<GarnetSimObject*> getSimObjects() const;
+
+    // Checkpointing of the network and every component built on it (see
+    // Checkpoint.hh).  Generators attached to the NIs are included.
+    void saveState(CheckpointOut& cp) const;
+    void loadState(CheckpointIn& cp);
+
     // Factory method (accepts optional chiplet params)
     static Topology* create(std::string name, GarnetNetwork* net,
                             int rows, int cols, int depth,
@@ -54,7 +67,8 @@ public:
     void set_vcs_per_vnet(int n) { m_vcs_per_vnet = n; }
 
 protected:
-    // Helper to connect two routers (unidirectional)
+    // Helper to connect two routers (unidirectional).  Credits return over
+    // the same channel, so the credit link gets the flit link's latency.
     void connectRouters(int src_id, int dest_id, int link_id_base,
                         std::string src_out_dir, std::string dest_in_dir,
                         int latency = 1);
@@ -73,7 +87,8 @@ protected:
     int m_num_vns;
     int m_vcs_per_vnet;
 
-    // Components owned by Topology
+    // Components owned by Topology; the links belong to the arena of the
+    // router they feed (see connectRouters()).
     std::vector<Router*> m_routers;
     std::vector<NetworkInterface*> m_nis;
     std::vector<SimpleTrafficGenerator*> m_tgs;
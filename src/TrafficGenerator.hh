@@ -5,7 +5,10 @@
 #ifndef __TRAFFIC_GENERATOR_HH__
 #define __TRAFFIC_GENERATOR_HH__
 
+#include <cmath>
 #include <cstdint>
+#include "Checkpoint.hh"
+#include "CounterRng.hh"
 #include "flit.hh"
 #include "StandaloneStats.hh"
 
@@ -27,10 +30,21 @@ public:
     virtual void     set_trace_packet(bool)     = 0;
     virtual void     set_seed(int)              = 0;
 
-    // Scheduling (may be no-ops).
-    virtual void     schedule_next_injection(uint64_t) = 0;
+    // Injection decisions are independent trials, one per cycle, so rather
+    // than drawing every cycle a generator samples how many trials fail
+    // before the next success (a geometric gap) and sleeps until then.
+    // Draws the first cycle at or after `from` at which a packet is made.
+    virtual void     schedule_next_injection(uint64_t from) = 0;
+
+    // Earliest cycle at which send_flit() has to run: the current cycle
+    // (or earlier) while it has flits to hand out, else the next sampled
+    // injection, or (uint64_t)-1 while idle until the next receive_flit().
     virtual uint64_t get_next_injection_time() const   = 0;
 
+    // The NI was not polled for `cycles` idle cycles; account for them as
+    // if send_flit() had been called (and found nothing to do) on each.
+    virtual void     skip_idle_cycles(uint64_t cycles)  = 0;
+
     // Statistics.
     virtual uint64_t get_total_latency()      = 0;
     virtual uint64_t get_received_packets()   = 0;
@@ -39,12 +53,43 @@ public:
     virtual uint64_t get_received_vnet(int)   = 0;
     virtual uint64_t get_latency_vnet(int)    = 0;
 
+    // Checkpointing: queued flits, statistics and random number state.
+    virtual void     saveState(CheckpointOut& cp) const = 0;
+    virtual void     loadState(CheckpointIn& cp)        = 0;
+
     // Latency histogram — overridden by SimpleTrafficGenerator.
     // PaceTrafficGenerator keeps the histogram in PaceAdapter; returns empty here.
     virtual const LatHist& get_lat_hist() const {
         static const LatHist empty;
         return empty;
     }
+
+protected:
+    // What a generator draws random numbers for.  Each purpose has a
+    // CounterRng stream of its own, keyed (seed, node id, purpose), so the
+    // draws for one never shift those for another.
+    enum RngStream : uint32_t {
+        INJECTION_STREAM,   // when to inject
+        PACKET_STREAM,      // what to inject: vnet, size, destination
+        DRAIN_STREAM,       // PACE MSHR drain
+        RESPONSE_STREAM,    // PACE directory response sizes
+    };
+
+    // Failures before the first success of trials that each succeed with
+    // probability p, from u uniform in [0, 1); (uint64_t)-1 if p <= 0.
+    static uint64_t geometric_gap(double p, double u)
+    {
+        if (p >= 1.0) return 0;
+        if (!(p > 0.0)) return (uint64_t)-1;
+        double gap = std::floor(std::log1p(-u) / std::log1p(-p));
+        return gap < 1e18 ? (uint64_t)gap : (uint64_t)-1;
+    }
+
+    // `time` + `delay`, staying at (uint64_t)-1 (never).
+    static uint64_t after(uint64_t time, uint64_t delay)
+    {
+        return delay > (uint64_t)-1 - time ? (uint64_t)-1 : time + delay;
+    }
 };
 
 } // namespace garnet
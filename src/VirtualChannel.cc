@@ -31,6 +31,7 @@
 
 #include "VirtualChannel.hh"
 #include "NetDest.hh" // Added to resolve incomplete type warning
+#include "Checkpoint.hh"
 
 namespace garnet
 {
@@ -86,4 +87,26 @@ VirtualChannel::getInputBuffer() const
     return inputBuffer;
 }
 
+void
+VirtualChannel::saveState(CheckpointOut& cp) const
+{
+    inputBuffer.saveState(cp);
+    cp.put(m_vc_state.first);
+    cp.put(m_vc_state.second);
+    cp.put(m_output_port);
+    cp.put(m_enqueue_time);
+    cp.put(m_output_vc);
+}
+
+void
+VirtualChannel::loadState(CheckpointIn& cp)
+{
+    inputBuffer.loadState(cp);
+    cp.get(m_vc_state.first);
+    cp.get(m_vc_state.second);
+    cp.get(m_output_port);
+    cp.get(m_enqueue_time);
+    cp.get(m_output_vc);
+}
+
 } // namespace garnet
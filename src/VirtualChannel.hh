@@ -91,6 +91,11 @@ class VirtualChannel
     }
 
     const flitBuffer& getInputBuffer() const;
+    // Bounds the input buffer at the VC depth; call before first use.
+    void set_depth(int depth)               { inputBuffer.setMaxSize(depth); }
+
+    void saveState(CheckpointOut& cp) const;
+    void loadState(CheckpointIn& cp);
 
   private:
     flitBuffer inputBuffer;
@@ -32,29 +32,25 @@
 
 #include <cmath>
 
+#include "Checkpoint.hh"
+
 namespace garnet
 {
 
 // Constructor for the flit
-flit::flit(int packet_id, int id, int  vc, int vnet, RouteInfo route, int size,
-    void* msg_ptr, int MsgSize, uint32_t bWidth, uint64_t curTime)
+flit::flit(PacketHeader* packet, int id, int vc, int vnet, int size,
+           uint32_t bWidth, uint64_t curTime)
 {
+    set_packet(packet);
     m_size = size;
-    m_msg_ptr = msg_ptr;
     m_enqueue_time = curTime;
-    m_dequeue_time = curTime;
     m_time = curTime;
-    m_creation_time = curTime;
-    m_packet_id = packet_id;
     m_id = id;
     m_vnet = vnet;
     m_vc = vc;
-    m_route = route;
-    m_trace = false;
-    m_stage.first = I_;
-    m_stage.second = curTime;
+    m_stage = I_;
+    m_stage_time = curTime;
     m_width = bWidth;
-    msgSize = MsgSize;
 
     if (size == 1) {
         m_type = HEAD_TAIL_;
@@ -68,90 +64,172 @@ flit::flit(int packet_id, int id, int  vc, int vnet, RouteInfo route, int size,
         m_type = BODY_;
 }
 
+// Credit Signal for buffers inside VC
+// Carries m_vc and m_free_signal (whether VC is free or not)
+flit::flit(int vc, bool is_free_signal, uint64_t curTime)
+{
+    m_enqueue_time = curTime;
+    m_time = curTime;
+    m_vc = vc;
+    m_stage = I_;
+    m_stage_time = curTime;
+    m_type = CREDIT_;
+    m_free_signal = is_free_signal;
+}
+
+flit::~flit()
+{
+    if (m_packet && m_packet->m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete m_packet;
+}
+
+void
+flit::set_packet(PacketHeader* packet)
+{
+    m_packet = packet;
+    if (packet) packet->m_refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+flit::saveState(CheckpointOut& cp) const
+{
+    cp.put(m_width);
+    cp.put(m_id);
+    cp.put(m_vnet);
+    cp.put(m_vc);
+    cp.put(m_size);
+    cp.put(m_enqueue_time);
+    cp.put(m_time);
+    cp.put(m_type);
+    cp.put(m_outport);
+    cp.put(m_hops);
+    cp.put(m_free_signal);
+    cp.put(m_stage);
+    cp.put(m_stage_time);
+
+    cp.put(m_packet != nullptr);
+    if (!m_packet) return;
+    const RouteInfo& route = m_packet->route;
+    cp.put(route.vnet);
+    cp.put(route.net_dest.getDestinations());
+    cp.put(route.src_ni);
+    cp.put(route.src_router);
+    cp.put(route.dest_ni);
+    cp.put(route.dest_router);
+    cp.put(m_packet->packet_id);
+    cp.put(m_packet->msg_size);
+    cp.put(m_packet->creation_time);
+    cp.put(m_packet->trace);
+    cp.put(m_packet->measured);
+}
+
+void
+flit::loadState(CheckpointIn& cp)
+{
+    cp.get(m_width);
+    cp.get(m_id);
+    cp.get(m_vnet);
+    cp.get(m_vc);
+    cp.get(m_size);
+    cp.get(m_enqueue_time);
+    cp.get(m_time);
+    cp.get(m_type);
+    cp.get(m_outport);
+    cp.get(m_hops);
+    cp.get(m_free_signal);
+    cp.get(m_stage);
+    cp.get(m_stage_time);
+
+    bool has_packet = false;
+    cp.get(has_packet);
+    if (!has_packet) return;
+    PacketHeader* packet = new PacketHeader;
+    RouteInfo& route = packet->route;
+    std::vector<int> destinations;
+    cp.get(route.vnet);
+    cp.get(destinations);
+    for (int dest : destinations) route.net_dest.add(dest);
+    cp.get(route.src_ni);
+    cp.get(route.src_router);
+    cp.get(route.dest_ni);
+    cp.get(route.dest_router);
+    cp.get(packet->packet_id);
+    cp.get(packet->msg_size);
+    cp.get(packet->creation_time);
+    cp.get(packet->trace);
+    cp.get(packet->measured);
+    set_packet(packet);
+}
+
 flit *
 flit::serialize(int ser_id, int parts, uint32_t bWidth)
 {
+    if (m_type == CREDIT_) {
+        bool new_free = false;
+        if ((ser_id+1 == parts) && m_free_signal) {
+            new_free = true;
+        }
+        return new flit(m_vc, new_free, m_time);
+    }
+
     assert(m_width > bWidth);
 
     int ratio = (int)std::ceil((float)m_width / bWidth);
     int new_id = (m_id*ratio) + ser_id;
-    int new_size = (int)std::ceil((float)msgSize / (float)bWidth);
+    int new_size = (int)std::ceil((float)get_msg_size() / (float)bWidth);
     assert(new_id < new_size);
 
-    flit *fl = new flit(m_packet_id, new_id, m_vc, m_vnet, m_route,
-                    new_size, m_msg_ptr, msgSize, bWidth, m_time);
+    flit *fl = new flit(m_packet, new_id, m_vc, m_vnet, new_size, bWidth,
+                        m_time);
     fl->set_enqueue_time(m_enqueue_time);
-    fl->set_src_delay(src_delay);
     return fl;
 }
 
 flit *
 flit::deserialize(int des_id, int num_flits, uint32_t bWidth)
 {
+    if (m_type == CREDIT_) {
+        // If this is a free signal we are not going to get any more
+        // credits for this vc, so send a credit in any case
+        return new flit(m_vc, m_free_signal, m_time);
+    }
+
     int ratio = (int)std::ceil((float)bWidth / (float)m_width);
     int new_id = ((int)std::ceil((float)(m_id+1) / (float)ratio)) - 1;
-    int new_size = (int)std::ceil((float)msgSize / (float)bWidth);
+    int new_size = (int)std::ceil((float)get_msg_size() / (float)bWidth);
     assert(new_id < new_size);
 
-    flit *fl = new flit(m_packet_id, new_id, m_vc, m_vnet, m_route,
-                    new_size, m_msg_ptr, msgSize, bWidth, m_time);
+    flit *fl = new flit(m_packet, new_id, m_vc, m_vnet, new_size, bWidth,
+                        m_time);
     fl->set_enqueue_time(m_enqueue_time);
-    fl->set_src_delay(src_delay);
     return fl;
 }
 
-flit::~flit()
-{
-}
-
-// The following methods are removed for the standalone version
-// flit *
-// flit::serialize(int ser_id, int parts, uint32_t bWidth)
-// {
-//     assert(m_width > bWidth);
-
-//     int ratio = (int)std::ceil((float)m_width / bWidth);
-//     int new_id = (m_id*ratio) + ser_id;
-//     int new_size = (int)std::ceil((float)msgSize / (float)bWidth);
-//     assert(new_id < new_size);
-
-//     flit *fl = new flit(m_packet_id, new_id, m_vc, m_vnet, m_route,
-//                     new_size, m_msg_ptr, msgSize, bWidth, m_time);
-//     fl->set_enqueue_time(m_enqueue_time);
-//     fl->set_src_delay(src_delay);
-//     return fl;
-// }
-
-// flit *
-// flit::deserialize(int des_id, int num_flits, uint32_t bWidth)
-// {
-//     int ratio = (int)std::ceil((float)bWidth / (float)m_width);
-//     int new_id = ((int)std::ceil((float)(m_id+1) / (float)ratio)) - 1;
-//     int new_size = (int)std::ceil((float)msgSize / (float)bWidth);
-//     assert(new_id < new_size);
-
-//     flit *fl = new flit(m_packet_id, new_id, m_vc, m_vnet, m_route,
-//                     new_size, m_msg_ptr, msgSize, bWidth, m_time);
-//     fl->set_enqueue_time(m_enqueue_time);
-//     fl->set_src_delay(src_delay);
-//     return fl;
-// }
-
 // Flit can be printed out for debugging purposes
 void
 flit::print(std::ostream& out) const
 {
+    if (m_type == CREDIT_) {
+        out << "[Credit:: ";
+        out << "Type=" << (int)m_type << " ";
+        out << "VC=" << m_vc << " ";
+        out << "FreeVC=" << m_free_signal << " ";
+        out << "Set Time=" << m_time << " ";
+        out << "]";
+        return;
+    }
+    const RouteInfo& route = m_packet->route;
     out << "[flit:: ";
-    out << "PacketId=" << m_packet_id << " ";
+    out << "PacketId=" << m_packet->packet_id << " ";
     out << "Id=" << m_id << " ";
-    out << "Type=" << m_type << " ";
+    out << "Type=" << (int)m_type << " ";
     out << "Size=" << m_size << " ";
-    out << "Vnet=" << m_vnet << " ";
+    out << "Vnet=" << (int)m_vnet << " ";
     out << "VC=" << m_vc << " ";
-    out << "Src NI=" << m_route.src_ni << " ";
-    out << "Src Router=" << m_route.src_router << " ";
-    out << "Dest NI=" << m_route.dest_ni << " ";
-    out << "Dest Router=" << m_route.dest_router << " ";
+    out << "Src NI=" << route.src_ni << " ";
+    out << "Src Router=" << route.src_router << " ";
+    out << "Dest NI=" << route.dest_ni << " ";
+    out << "Dest Router=" << route.dest_router << " ";
     out << "Set Time=" << m_time << " ";
     out << "Width=" << m_width<< " ";
     out << "]";
@@ -31,70 +31,132 @@
 #ifndef __GARNET_FLIT_HH__
 #define __GARNET_FLIT_HH__
 
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <cstdint>
+#include <utility>
 
 #include "CommonTypes.hh"
+#include "FlitPool.hh"
 #include "NetDest.hh"
 
 namespace garnet
 {
 
+class CheckpointIn;
+class CheckpointOut;
+
+// What all flits of a packet have in common: created by the traffic
+// generator with the packet and freed with the last flit referring to it
+// (including the parts a NetworkBridge splits flits into).  Read-only once
+// the flits are built, so routers on different threads may share it.
+struct PacketHeader
+{
+    RouteInfo route;
+    int packet_id = 0;
+    int msg_size = 0;            // bytes, for serialization
+    uint64_t creation_time = 0;
+    bool trace = false;
+    // Injected during a measurement window (see
+    // SimpleTrafficGenerator::set_measure_window).
+    bool measured = false;
+
+    static void* operator new(size_t size) { return FlitPool::allocate(size); }
+    static void operator delete(void* p, size_t size)
+    {
+        FlitPool::release(p, size);
+    }
+
+  private:
+    friend class flit;
+    // Flits referring to the header; flits of one packet may be freed on
+    // different threads.
+    std::atomic<int> m_refs{0};
+};
+
+// A flit, or a credit (type CREDIT_, no packet).  Kept to one cache line:
+// per-packet data lives in the shared PacketHeader.
 class flit
 {
   public:
     flit() {}
-    flit(int packet_id, int id, int vc, int vnet, RouteInfo route, int size,
-         void* msg_ptr, int MsgSize, uint32_t bWidth, uint64_t curTime);
+    // Takes a reference on `packet`.
+    flit(PacketHeader* packet, int id, int vc, int vnet, int size,
+         uint32_t bWidth, uint64_t curTime);
+    // A credit for `vc`.
+    flit(int vc, bool is_free_signal, uint64_t curTime);
+
+    ~flit();
+
+    flit(const flit&) = delete;
+    flit& operator=(const flit&) = delete;
 
-    virtual ~flit();
+    // Flits and credits live in FlitPool slots.
+    static void* operator new(size_t size) { return FlitPool::allocate(size); }
+    static void operator delete(void* p, size_t size)
+    {
+        FlitPool::release(p, size);
+    }
 
     int get_outport() {return m_outport; }
     int get_size() { return m_size; }
     uint64_t get_enqueue_time() { return m_enqueue_time; }
-    uint64_t get_dequeue_time() { return m_dequeue_time; }
-    uint64_t get_creation_time() { return m_creation_time; }
-    int getPacketID() { return m_packet_id; }
+    uint64_t get_creation_time() const
+    {
+        return m_packet ? m_packet->creation_time : 0;
+    }
+    int getPacketID() const { return m_packet ? m_packet->packet_id : 0; }
+    int get_msg_size() const { return m_packet ? m_packet->msg_size : 0; }
     int get_id() { return m_id; }
     uint64_t get_time() { return m_time; }
     int get_vnet() { return m_vnet; }
     int get_vc() { return m_vc; }
-    RouteInfo get_route() { return m_route; }
-    void* get_msg_ptr() { return m_msg_ptr; }
-    flit_type get_type() { return m_type; }
-    std::pair<flit_stage, uint64_t> get_stage() { return m_stage; }
-    uint64_t get_src_delay() { return src_delay; }
+    // Data flits only.
+    const PacketHeader& get_packet() const { return *m_packet; }
+    const RouteInfo& get_route() const { return m_packet->route; }
+    flit_type get_type() { return (flit_type)m_type; }
+    std::pair<flit_stage, uint64_t> get_stage()
+    {
+        return std::make_pair((flit_stage)m_stage, m_stage_time);
+    }
+    int get_hops() const { return m_hops; }
 
     void set_outport(int port) { m_outport = port; }
     void set_time(uint64_t time) { m_time = time; }
     void set_vc(int vc) { m_vc = vc; }
-    void set_route(RouteInfo route) { m_route = route; }
-    void set_src_delay(uint64_t delay) { src_delay = delay; }
-    void set_dequeue_time(uint64_t time) { m_dequeue_time = time; }
     void set_enqueue_time(uint64_t time) { m_enqueue_time = time; }
 
-    void set_trace(bool trace) { m_trace = trace; }
-    bool get_trace() const { return m_trace; }
+    bool get_trace() const { return m_packet && m_packet->trace; }
+    bool is_measured() const { return m_packet && m_packet->measured; }
+
+    // Credits: whether the VC is free again.
+    bool is_free_signal() const { return m_free_signal; }
 
-    void increment_hops() { m_route.hops_traversed++; }
-    virtual void print(std::ostream& out) const;
+    void increment_hops() { m_hops++; }
+    void print(std::ostream& out) const;
 
-    virtual flit* serialize(int ser_id, int parts, uint32_t bWidth);
-    virtual flit* deserialize(int des_id, int num_flits, uint32_t bWidth);
+    flit* serialize(int ser_id, int parts, uint32_t bWidth);
+    flit* deserialize(int des_id, int num_flits, uint32_t bWidth);
+
+    // Checkpointing; see CheckpointOut::putFlit and CheckpointIn::getFlit.
+    // The packet header is stored with every flit, so flits of a packet
+    // get a header each on restore.
+    void saveState(CheckpointOut& cp) const;
+    void loadState(CheckpointIn& cp);
 
     bool
     is_stage(flit_stage stage, uint64_t time)
     {
-        return (stage == m_stage.first &&
-                time >= m_stage.second);
+        return (stage == m_stage &&
+                time >= m_stage_time);
     }
 
     void
     advance_stage(flit_stage t_stage, uint64_t newTime)
     {
-        m_stage.first = t_stage;
-        m_stage.second = newTime;
+        m_stage = t_stage;
+        m_stage_time = newTime;
     }
 
     static bool
@@ -108,26 +170,31 @@ class flit
         }
     }
 
-    uint32_t m_width;
-    int msgSize;
-  protected:
-    int m_packet_id;
-    int m_id;
-    int m_vnet;
-    int m_vc;
-    RouteInfo m_route;
-    int m_size;
-    uint64_t m_enqueue_time, m_dequeue_time;
-    uint64_t m_time;
-    uint64_t m_creation_time;
-    flit_type m_type;
-    void* m_msg_ptr;
-    int m_outport;
-    uint64_t src_delay;
-    bool m_trace = false;
-    std::pair<flit_stage, uint64_t> m_stage;
+  private:
+    void set_packet(PacketHeader* packet);
+
+    PacketHeader* m_packet = nullptr;   // null for credits
+    uint64_t m_enqueue_time = 0;
+    uint64_t m_time = 0;
+    uint64_t m_stage_time = 0;
+    uint32_t m_width = 0;
+    int32_t m_id = 0;
+    int32_t m_size = 0;
+    int16_t m_vc = 0;
+    int16_t m_outport = 0;
+    int16_t m_hops = 0;
+    uint8_t m_vnet = 0;
+    uint8_t m_type = HEAD_TAIL_;
+    uint8_t m_stage = I_;
+    bool m_free_signal = false;
 };
 
+static_assert(sizeof(flit) <= 64, "a flit should fit in a cache line");
+static_assert(sizeof(PacketHeader) <=
+                  FlitPool::kSizeClasses * FlitPool::kCacheLine,
+              "a PacketHeader should fit in a FlitPool slot; a larger "
+              "NETDEST_NIS needs more size classes");
+
 inline std::ostream&
 operator<<(std::ostream& out, const flit& obj)
 {
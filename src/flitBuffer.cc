@@ -31,52 +31,92 @@
 
 #include "flitBuffer.hh"
 
+#include "Checkpoint.hh"
+
 namespace garnet
 {
 
 flitBuffer::flitBuffer()
+  : m_slots(m_inline), m_mask(kInlineSlots - 1), max_size(-1)
 {
-    max_size = -1;
 }
 
 flitBuffer::flitBuffer(int maximum_size)
+  : m_slots(m_inline), m_mask(kInlineSlots - 1), max_size(-1)
+{
+    setMaxSize(maximum_size);
+}
+
+flitBuffer::flitBuffer(const flitBuffer& other)
+  : m_slots(m_inline), m_mask(kInlineSlots - 1), max_size(-1)
 {
-    max_size = maximum_size;
+    setMaxSize(other.max_size);
+    for (uint32_t i = 0; i < other.m_count; ++i)
+        insert(other.m_slots[(other.m_head + i) & other.m_mask]);
 }
 
-bool
-flitBuffer::isEmpty() const
+flitBuffer&
+flitBuffer::operator=(const flitBuffer& other)
 {
-    return (m_buffer.size() == 0);
+    if (this == &other) return *this;
+    m_head = 0;
+    m_count = 0;
+    setMaxSize(other.max_size);
+    for (uint32_t i = 0; i < other.m_count; ++i)
+        insert(other.m_slots[(other.m_head + i) & other.m_mask]);
+    return *this;
 }
 
-bool
-flitBuffer::isReady(uint64_t curTime)
+flitBuffer::~flitBuffer()
 {
-    if (m_buffer.size() != 0 ) {
-        flit *t_flit = peekTopFlit();
-        if (t_flit->get_time() <= curTime)
-            return true;
-    }
-    return false;
+    if (m_slots != m_inline) delete[] m_slots;
 }
 
 void
-flitBuffer::print(std::ostream& out) const
+flitBuffer::grow(uint32_t capacity)
 {
-    out << "[flitBuffer: " << m_buffer.size() << "] " << std::endl;
+    flit **slots = new flit*[capacity];
+    for (uint32_t i = 0; i < m_count; ++i)
+        slots[i] = m_slots[(m_head + i) & m_mask];
+    if (m_slots != m_inline) delete[] m_slots;
+    m_slots = slots;
+    m_mask = capacity - 1;
+    m_head = 0;
 }
 
-bool
-flitBuffer::isFull()
+void
+flitBuffer::print(std::ostream& out) const
 {
-    return (m_buffer.size() >= max_size);
+    out << "[flitBuffer: " << m_count << "] " << std::endl;
 }
 
 void
 flitBuffer::setMaxSize(int maximum)
 {
+    assert(maximum < 0 || (int)m_count <= maximum);
     max_size = maximum;
+    uint32_t capacity = m_mask + 1;
+    while ((int)capacity < maximum) capacity *= 2;
+    if (capacity > m_mask + 1) grow(capacity);
+}
+
+void
+flitBuffer::saveState(CheckpointOut& cp) const
+{
+    cp.put((uint64_t)m_count);
+    for (uint32_t i = 0; i < m_count; ++i)
+        cp.putFlit(m_slots[(m_head + i) & m_mask]);
+}
+
+void
+flitBuffer::loadState(CheckpointIn& cp)
+{
+    while (m_count > 0) delete getTopFlit();
+    m_head = 0;
+    uint64_t size = 0;
+    cp.get(size);
+    for (uint64_t i = 0; i < size && cp.ok(); ++i)
+        if (flit* t_flit = cp.getFlit()) insert(t_flit);
 }
 
 } // namespace garnet
@@ -32,10 +32,10 @@
 #define __GARNET_FLIT_BUFFER_HH__
 
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <vector>
 #include <cstdint>
-#include <deque>
 
 #include "CommonTypes.hh"
 #include "flit.hh"
@@ -44,42 +44,88 @@
 namespace garnet
 {
 
+class CheckpointIn;
+class CheckpointOut;
+
+// FIFO of flits (or credits) in a power-of-two ring.  The first
+// kInlineSlots slots live inside the buffer itself.  A buffer given a
+// maximum size is bounded: its ring is allocated once, up front, and
+// insert() asserts rather than grows, since overflowing a credit-managed
+// buffer means flow control has broken.  VC input buffers are sized from
+// the VC depth, and output-unit and credit queues from the credits they
+// stand for.  Unbounded buffers (the generator and NI source queues) move
+// to a heap ring that doubles as needed.  Buffered flits are owned by the
+// component using the buffer, not by the buffer.
 class flitBuffer
 {
   public:
     flitBuffer();
+    // A buffer bounded at maximum_size flits; see setMaxSize().
     flitBuffer(int maximum_size);
+    flitBuffer(const flitBuffer& other);
+    flitBuffer& operator=(const flitBuffer& other);
+    ~flitBuffer();
+
+    bool
+    isReady(uint64_t curTime) const
+    {
+        return m_count != 0 && m_slots[m_head]->get_time() <= curTime;
+    }
 
-    bool isReady(uint64_t curTime);
-    bool isEmpty() const;
+    bool isEmpty() const { return m_count == 0; }
     void print(std::ostream& out) const;
-    bool isFull();
+
+    bool
+    isFull() const
+    {
+        return max_size >= 0 && (int)m_count >= max_size;
+    }
+
+    // Bounds the buffer at `maximum` flits (negative: unbounded) and sizes
+    // the ring for them.  Call before the buffer is in use.
     void setMaxSize(int maximum);
-    int getSize() const { return m_buffer.size(); }
+    int getSize() const { return m_count; }
+
+    // Saves the buffered flits; loadState() frees the current ones first.
+    void saveState(CheckpointOut& cp) const;
+    void loadState(CheckpointIn& cp);
 
     flit *
     getTopFlit()
     {
-        flit *f = m_buffer.front();
-        m_buffer.pop_front();
+        flit *f = m_slots[m_head];
+        m_head = (m_head + 1) & m_mask;
+        --m_count;
         return f;
     }
 
     flit *
     peekTopFlit()
     {
-        return m_buffer.front();
+        return m_slots[m_head];
     }
 
     void
     insert(flit *flt)
     {
-        m_buffer.push_back(flt);
+        assert(!isFull());
+        if (m_count > m_mask) grow(2 * (m_mask + 1));
+        m_slots[(m_head + m_count) & m_mask] = flt;
+        ++m_count;
     }
 
   private:
-    std::deque<flit *> m_buffer;
+    static const uint32_t kInlineSlots = 4;
+
+    // Moves the contents to a heap ring of `capacity` (a power of two).
+    void grow(uint32_t capacity);
+
+    flit **m_slots;
+    uint32_t m_mask;
+    uint32_t m_head = 0;
+    uint32_t m_count = 0;
     int max_size;
+    flit *m_inline[kInlineSlots];
 };
 
 inline std::ostream&
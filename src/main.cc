@@ -9,6 +9,18 @@
 #include <sstream>
 #include <map>
 #include <cmath>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <iterator>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "GarnetNetwork.hh"
 #include "Topology.hh"
@@ -16,6 +28,9 @@
 #include "NetworkLink.hh"
 #include "PaceAdapter.hh"
 #include "PaceProfile.hh"
+#include "Checkpoint.hh"
+#include "FlitPool.hh"
+#include "SimKernel.hh"
 #include "StandaloneStats.hh"
 #include "SimpleTrafficGenerator.hh"
 
@@ -81,6 +96,42 @@ struct SimConfig {
     // New fields (spec-compliant)
     std::string topo_id = "";
     bool        uniform_mode = false;  // --uniform: profile-aware uniform injection
+
+    // Execution engine: --kernel=activity (default) | sweep | phased
+    SimKernel::Mode kernel_mode = SimKernel::ACTIVITY_DRIVEN;
+    int             threads     = 1;   // --threads: router partitions
+    // --router-kernel=fixed (default) | generic: RouterKernel.hh shapes
+    bool generic_router_kernels = false;
+
+    // Sweep execution: --jobs runs at once, --seeds replications per point
+    int jobs  = 1;
+    int seeds = 1;
+    // --fork-warmup: uniform sweep runs branch from one network warmed up
+    // for this many cycles (0 = every run starts from an empty network)
+    uint64_t fork_warmup = 0;
+
+    // Checkpoints of PACE runs: every --checkpoint-every cycles to
+    // --checkpoint-file (default <pace-output>.ckpt); --restore continues
+    // from one
+    uint64_t    checkpoint_every = 0;
+    std::string checkpoint_file  = "";
+    std::string restore_path     = "";
+
+    // --find-saturation: bisect on the injection rate instead of running
+    bool find_saturation = false;
+
+    // Measurement methodology of single uniform runs (run_measurement):
+    // --warmup and --drain cycles around the measurement, --batch-cycles
+    // per batch-means sample (0 = a twentieth of the window) and
+    // --ci-target relative CI to stop at (0 = run all --cycles)
+    uint64_t warmup_cycles = 0;
+    uint64_t drain_cycles  = 0;
+    uint64_t batch_cycles  = 0;
+    double   ci_target     = 0.0;
+
+    // --compile-profile: write the --pace-profile as a binary image to this
+    // path and exit
+    std::string compile_profile = "";
 };
 
 void parse_args(int argc, char** argv, SimConfig& config) {
@@ -144,6 +195,26 @@ void parse_args(int argc, char** argv, SimConfig& config) {
         {"no-dir-remap",          no_argument,   0, 3009}, // alias --pace-no-remap
         {"uniform-destinations",  no_argument,   0, 3010}, // alias --pace-no-weighted-dest
         {"no-correlated-responses", no_argument, 0, 3011}, // alias --pace-no-corr-response
+        // Execution engine
+        {"kernel",                required_argument, 0, 4000},
+        {"threads",               required_argument, 0, 4001},
+        {"router-kernel",         required_argument, 0, 4013},
+        // Sweep execution
+        {"jobs",                  required_argument, 0, 4002},
+        {"seeds",                 required_argument, 0, 4003},
+        {"fork-warmup",           required_argument, 0, 4004},
+        // Checkpoints
+        {"checkpoint-every",      required_argument, 0, 4005},
+        {"checkpoint-file",       required_argument, 0, 4006},
+        {"restore",               required_argument, 0, 4007},
+        {"find-saturation",       no_argument,       0, 4008},
+        // Measurement windows
+        {"warmup",                required_argument, 0, 4009},
+        {"drain",                 required_argument, 0, 4010},
+        {"batch-cycles",          required_argument, 0, 4011},
+        {"ci-target",             required_argument, 0, 4012},
+        // Compiled profile images
+        {"compile-profile",       required_argument, 0, 4014},
         {0, 0, 0, 0}
     };
 
@@ -215,8 +286,83 @@ void parse_args(int argc, char** argv, SimConfig& config) {
             case 3009: config.pace_no_remap         = true; break;
             case 3010: config.pace_no_weighted_dest = true; break;
             case 3011: config.pace_no_corr_response = true; break;
+
+            // Execution engine
+            case 4000:
+                if (!SimKernel::parse_mode(optarg, config.kernel_mode)) {
+                    std::cerr << "ERROR: unknown --kernel '" << optarg
+                              << "' (expected sweep, activity or phased)\n";
+                    std::exit(1);
+                }
+                break;
+            case 4001:
+                config.threads = std::atoi(optarg);
+                if (config.threads < 1) {
+                    std::cerr << "ERROR: --threads must be at least 1\n";
+                    std::exit(1);
+                }
+                break;
+
+            case 4013:
+                if (std::string(optarg) == "fixed") {
+                    config.generic_router_kernels = false;
+                } else if (std::string(optarg) == "generic") {
+                    config.generic_router_kernels = true;
+                } else {
+                    std::cerr << "ERROR: unknown --router-kernel '" << optarg
+                              << "' (expected fixed or generic)\n";
+                    std::exit(1);
+                }
+                break;
+
+            // Sweep execution
+            case 4002:
+                config.jobs = std::atoi(optarg);
+                if (config.jobs < 1) {
+                    std::cerr << "ERROR: --jobs must be at least 1\n";
+                    std::exit(1);
+                }
+                break;
+            case 4003:
+                config.seeds = std::atoi(optarg);
+                if (config.seeds < 1) {
+                    std::cerr << "ERROR: --seeds must be at least 1\n";
+                    std::exit(1);
+                }
+                break;
+            case 4004:
+                config.fork_warmup = std::strtoull(optarg, nullptr, 10);
+                break;
+
+            // Checkpoints
+            case 4005:
+                config.checkpoint_every = std::strtoull(optarg, nullptr, 10);
+                break;
+            case 4006: config.checkpoint_file = optarg; break;
+            case 4007: config.restore_path    = optarg; break;
+            case 4008: config.find_saturation = true; break;
+
+            // Measurement windows
+            case 4009:
+                config.warmup_cycles = std::strtoull(optarg, nullptr, 10);
+                break;
+            case 4010:
+                config.drain_cycles = std::strtoull(optarg, nullptr, 10);
+                break;
+            case 4011:
+                config.batch_cycles = std::strtoull(optarg, nullptr, 10);
+                break;
+            case 4012: config.ci_target = std::atof(optarg); break;
+            case 4014: config.compile_profile = optarg; break;
         }
     }
+
+    // Trace and debug output is interleaved across the network and numbered
+    // with global packet ids, so it needs the serial order.
+    if (config.threads > 1 && (config.trace_packet || config.debug)) {
+        std::cerr << "WARNING: --trace-packet/--debug run on a single thread\n";
+        config.threads = 1;
+    }
 }
 
 // ---- Helper: parse "start:end:step" sweep range into a list of multipliers ----
@@ -245,9 +391,14 @@ static std::vector<double> parse_sweep_range(const std::string& s) {
 }
 
 // ---- Helper: write a latency histogram JSON block ----
-static void write_hist_json(std::ofstream& f, const LatHist& h) {
-    f << "  \"latency_histogram\": {\n"
-      << "    \"fine_counts\": [";
+// `batches` (optional) are the batch means the mean latency's CI is from.
+static void write_hist_json(std::ostream& f, const LatHist& h,
+                            const SampleStats* batches = nullptr) {
+    f << "  \"latency_histogram\": {\n";
+    if (batches)
+        f << "    \"mean_ci95\": " << batches->ci95() << ",\n"
+          << "    \"ci_batches\": " << batches->n << ",\n";
+    f << "    \"fine_counts\": [";
     for (size_t i = 0; i < h.fine.size(); ++i) { if (i > 0) f << ", "; f << h.fine[i]; }
     f << "],\n    \"coarse_counts\": [";
     for (size_t i = 0; i < h.coarse.size(); ++i) { if (i > 0) f << ", "; f << h.coarse[i]; }
@@ -257,7 +408,7 @@ static void write_hist_json(std::ofstream& f, const LatHist& h) {
 }
 
 // ---- Helper: write a link_utilization JSON block ----
-static void write_link_util_json(std::ofstream& f,
+static void write_link_util_json(std::ostream& f,
                                   const std::vector<NetworkLink*>& links,
                                   uint64_t total_cycles) {
     struct LI { int idx; double util; };
@@ -285,6 +436,111 @@ static void write_link_util_json(std::ofstream& f,
     f << "]\n  }";
 }
 
+// ---- Measurement windows ----
+
+// Batches a --ci-target run needs before it may stop early.
+static const int kMinBatches = 10;
+// Batches per measurement window when --batch-cycles is not given.
+static const int kDefaultBatches = 20;
+
+// Cycles of a run_measurement() and the batch-means latency estimate.
+struct Measurement {
+    uint64_t start = 0;        // measurement window [start, end)
+    uint64_t end = 0;
+    uint64_t finish = 0;       // end of the drain
+    uint64_t unfinished = 0;   // measured packets still in flight at finish
+    SampleStats batches;       // mean latency of each full batch
+
+    uint64_t cycles() const { return end - start; }
+    // Relative half-width of the 95% interval; 0 with fewer than 2 batches.
+    double relative_ci() const {
+        return batches.mean() > 0.0 ? batches.ci95() / batches.mean() : 0.0;
+    }
+};
+
+// Runs `tgs` through --warmup cycles, then measures for up to --cycles + 1
+// cycles in batches of --batch-cycles, then drains for up to --drain
+// cycles.  Only packets generated during measurement are counted.  Each
+// batch's mean latency is one sample of the batch-means estimator; with
+// --ci-target the measurement stops once the 95% interval of the mean is
+// within that fraction of it.  The drain keeps injecting (unmeasured
+// traffic) until every measured packet has arrived.  Link statistics start
+// with the measurement.
+static Measurement run_measurement(const SimConfig& config, SimKernel& kernel,
+                                   const std::vector<SimpleTrafficGenerator*>& tgs,
+                                   const std::vector<NetworkLink*>& links)
+{
+    Measurement m;
+    m.start = config.warmup_cycles;
+    for (auto tg : tgs) tg->set_measure_window(m.start, (uint64_t)-1);
+    if (m.start > 0) {
+        kernel.run(0, m.start);
+        for (auto link : links) link->resetStats();
+    }
+
+    uint64_t limit = m.start + (uint64_t)config.sim_cycles + 1;
+    uint64_t batch = config.batch_cycles > 0
+        ? config.batch_cycles
+        : std::max<uint64_t>(1, (limit - m.start) / kDefaultBatches);
+    uint64_t received = 0, latency = 0;
+    uint64_t t = m.start;
+#ifdef GARNET_POOL_DEBUG
+    FlitPool::Counters pool_at_start = FlitPool::counters();
+#endif
+    while (t < limit) {
+        uint64_t next = std::min(limit, t + batch);
+        kernel.run(t, next);
+        uint64_t batch_received = received, batch_latency = latency;
+        received = latency = 0;
+        for (auto tg : tgs) {
+            received += tg->get_received_packets();
+            latency  += tg->get_total_latency();
+        }
+        if (next - t == batch && received > batch_received)
+            m.batches.add((double)(latency - batch_latency) /
+                          (received - batch_received));
+        t = next;
+        if (config.ci_target > 0.0 && (int)m.batches.n >= kMinBatches &&
+            m.relative_ci() <= config.ci_target)
+            break;
+    }
+    m.end = t;
+    for (auto tg : tgs) tg->set_measure_window(m.start, m.end);
+#ifdef GARNET_POOL_DEBUG
+    // Below saturation nothing is allocated per packet and the pool holds
+    // every flit the buffers can; only source queues that reach a new peak
+    // still grow now and then.
+    uint64_t heap = FlitPool::counters().heap - pool_at_start.heap;
+    uint64_t slabs = FlitPool::counters().slabs - pool_at_start.slabs;
+    std::cerr << "FlitPool: " << heap << " heap allocations and " << slabs
+              << " new slabs while measuring " << received << " packets\n";
+    if (heap * 100 > received)
+        std::cerr << "WARNING: more than one heap allocation per 100 "
+                     "measured packets\n";
+    if (slabs > 0)
+        std::cerr << "WARNING: the flit pool grew while measuring\n";
+#endif
+
+    auto in_flight = [&]() {
+        uint64_t injected = 0, arrived = 0;
+        for (auto tg : tgs) {
+            injected += tg->get_injected_packets();
+            arrived  += tg->get_received_packets();
+        }
+        return injected > arrived ? injected - arrived : 0;
+    };
+    uint64_t drain_end = m.end + config.drain_cycles;
+    while (t < drain_end && in_flight() > 0) {
+        uint64_t next = std::min(drain_end, t + 16);
+        kernel.run(t, next);
+        t = next;
+    }
+    m.finish = t;
+    kernel.finish(t);
+    m.unfinished = in_flight();
+    return m;
+}
+
 // ---- Write full spec B.2 JSON for uniform mode ----
 static void write_uniform_json(const std::string& path,
                                 const LatHist& hist,
@@ -299,12 +555,15 @@ static void write_uniform_json(const std::string& path,
                                 int inter_latency,
                                 int inter_width,
                                 const std::string& benchmark,
-                                double lambda_multiplier) {
-    std::ofstream f(path);
-    if (!f.is_open()) {
+                                double lambda_multiplier,
+                                std::string* json = nullptr,
+                                const Measurement* measurement = nullptr) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
         std::cerr << "Uniform: cannot write results to " << path << "\n";
         return;
     }
+    std::ostringstream f;
 
     double avg_lat = total_packets > 0 ? (double)total_latency / total_packets : 0.0;
     double p50  = hist.percentile(0.50);
@@ -341,10 +600,23 @@ static void write_uniform_json(const std::string& path,
       << "  \"raw_total_flits\": "    << total_flits    << ",\n"
       << "  \"simulated_cycles\": "   << total_cycles   << ",\n"
       << "  \"lambda_multiplier\": "  << lambda_multiplier << ",\n";
+    // Links count from the measurement's start through the drain.
+    uint64_t link_cycles = total_cycles;
+    if (measurement) {
+        link_cycles = measurement->finish - measurement->start;
+        f << "  \"avg_packet_latency_ci95\": " << measurement->batches.ci95() << ",\n"
+          << "  \"measurement\": {\n"
+          << "    \"warmup_cycles\": "   << measurement->start << ",\n"
+          << "    \"measured_cycles\": " << measurement->cycles() << ",\n"
+          << "    \"drain_cycles\": "    << measurement->finish - measurement->end << ",\n"
+          << "    \"latency_ci_relative\": " << measurement->relative_ci() << ",\n"
+          << "    \"unfinished_packets\": " << measurement->unfinished << "\n"
+          << "  },\n";
+    }
 
-    write_hist_json(f, hist);
+    write_hist_json(f, hist, measurement ? &measurement->batches : nullptr);
     f << ",\n";
-    write_link_util_json(f, links, total_cycles);
+    write_link_util_json(f, links, link_cycles);
     f << ",\n"
       << "  \"saturation_detail\": {\n"
       << "    \"max_avg_mshr_occupancy\": 0.0,\n"
@@ -357,7 +629,9 @@ static void write_uniform_json(const std::string& path,
       << "    \"pct_vc_cycles_above_80\": 0.0\n"
       << "  }\n"
       << "}\n";
-    f.close();
+    out << f.str();
+    out.close();
+    if (json) *json = f.str();
 
     std::cout << "Uniform: results written to " << path << "\n"
               << "  method=" << method
@@ -366,6 +640,13 @@ static void write_uniform_json(const std::string& path,
               << "  throughput=" << throughput << " flits/cycle\n";
 }
 
+// ---- Helper: report event-queue wakeup coalescing ----
+static void print_wakeup_stats(const EventQueue* eq) {
+    std::cout << "  - Wakeups Scheduled: " << eq->get_scheduled_wakeups()
+              << " (coalesced duplicates: " << eq->get_coalesced_wakeups()
+              << ")\n";
+}
+
 // ---- Run standard (non-PACE, non-uniform-profile) simulation ----
 static void run_standard(const SimConfig& config, Topology* topo,
                           GarnetNetwork& network)
@@ -386,20 +667,17 @@ static void run_standard(const SimConfig& config, Topology* topo,
     for (auto router : topo->getRouters()) router->init();
 
     EventQueue* event_queue = network.getEventQueue();
-    for (uint64_t t = 0; t <= (uint64_t)config.sim_cycles; ++t) {
-        event_queue->set_current_time(t);
-        for (auto ni : topo->getNIs())         ni->wakeup();
-        for (auto router : topo->getRouters()) router->wakeup();
-        while (!event_queue->is_empty() &&
-               event_queue->peek_next_time() <= t) {
-            Event* ev = event_queue->get_next_event();
-            ev->get_obj()->wakeup();
-            delete ev;
-        }
-    }
+    SimKernel kernel(&network, topo->getNIs(), topo->getRouters(),
+                     config.kernel_mode, config.threads);
+    Measurement m = run_measurement(config, kernel, topo->getTGs(),
+                                    topo->getLinks());
+    uint64_t measured = m.cycles();
 
     std::cout << "\nSimulation Statistics:\n"
               << "  - Total Cycles: " << config.sim_cycles << "\n";
+    if (m.start > 0 || m.finish > m.end || m.end < m.start + config.sim_cycles + 1)
+        std::cout << "  - Measured Cycles: [" << m.start << ", " << m.end
+                  << "), drained until " << m.finish << "\n";
 
     uint64_t total_latency = 0, total_packets = 0, total_injected = 0;
     uint64_t vnet_pkts[2] = {0, 0}, vnet_lat[2] = {0, 0};
@@ -418,7 +696,13 @@ static void run_standard(const SimConfig& config, Topology* topo,
               << "  - Total Packets Received: " << total_packets << "\n";
     if (total_packets > 0) {
         std::cout << "  - Average Network Latency: "
-                  << (double)total_latency / total_packets << " cycles\n";
+                  << (double)total_latency / total_packets << " cycles\n"
+                  << "  - Latency 95% CI: +/- " << m.batches.ci95()
+                  << " cycles (" << m.relative_ci() * 100.0 << " % of "
+                  << m.batches.n << " batch means)\n";
+        if (config.drain_cycles > 0 && m.unfinished > 0)
+            std::cout << "  - Measured packets still in flight after drain: "
+                      << m.unfinished << "\n";
         for (int v = 0; v < 2; ++v) {
             if (vnet_pkts[v] > 0)
                 std::cout << "    - VNet " << v << ": Rx=" << vnet_pkts[v]
@@ -427,11 +711,13 @@ static void run_standard(const SimConfig& config, Topology* topo,
         }
     }
 
+    print_wakeup_stats(event_queue);
+
     double total_util = 0;
     int num_links = (int)topo->getLinks().size();
     if (num_links > 0) {
         for (auto link : topo->getLinks())
-            total_util += (double)link->getLinkUtilization() / config.sim_cycles;
+            total_util += (double)link->getLinkUtilization() / (m.finish - m.start);
         std::cout << "  - Average Link Utilization: "
                   << (total_util / num_links) * 100.0 << " %\n";
     }
@@ -443,8 +729,7 @@ static void run_standard(const SimConfig& config, Topology* topo,
         double avg_lat = total_packets > 0
                          ? (double)total_latency / total_packets : 0.0;
         uint64_t total_flits = total_packets * (uint64_t)config.packet_size;
-        double throughput = config.sim_cycles > 0
-                            ? (double)total_flits / config.sim_cycles : 0.0;
+        double throughput = measured > 0 ? (double)total_flits / measured : 0.0;
 
         std::ofstream jf(config.pace_output);
         if (jf.is_open()) {
@@ -455,11 +740,15 @@ static void run_standard(const SimConfig& config, Topology* topo,
                << "  \"throughput_flits_per_cycle\": " << throughput << ",\n"
                << "  \"raw_total_packets\": " << total_packets << ",\n"
                << "  \"raw_total_flits\": " << total_flits << ",\n"
-               << "  \"simulated_cycles\": " << config.sim_cycles << ",\n"
+               << "  \"simulated_cycles\": " << measured << ",\n"
+               << "  \"warmup_cycles\": " << m.start << ",\n"
+               << "  \"drain_cycles\": " << m.finish - m.end << ",\n"
                << "  \"packet_stats\": {\n"
                << "    \"total_packets_received\": " << total_packets << ",\n"
                << "    \"total_flits_received\": " << total_flits << ",\n"
                << "    \"avg_latency_cycles\": " << avg_lat << ",\n"
+               << "    \"avg_latency_ci95\": " << m.batches.ci95() << ",\n"
+               << "    \"ci_batches\": " << m.batches.n << ",\n"
                << "    \"p99_latency_cycles\": 0,\n"
                << "    \"throughput_flits_per_cycle\": " << throughput << "\n"
                << "  },\n"
@@ -479,7 +768,7 @@ static void run_standard(const SimConfig& config, Topology* topo,
 static void run_uniform(const SimConfig& config, Topology* topo,
                         GarnetNetwork& network)
 {
-    PaceProfile profile = PaceProfile::load(config.pace_profile);
+    const PaceProfile& profile = *PaceProfile::shared(config.pace_profile);
 
     double effective_lambda = profile.effective_lambda;
     if (effective_lambda <= 0.0) {
@@ -515,18 +804,10 @@ static void run_uniform(const SimConfig& config, Topology* topo,
     for (auto router : topo->getRouters()) router->init();
 
     EventQueue* event_queue = network.getEventQueue();
-    uint64_t t = 0;
-    for (; t <= (uint64_t)config.sim_cycles; ++t) {
-        event_queue->set_current_time(t);
-        for (auto ni : topo->getNIs())         ni->wakeup();
-        for (auto router : topo->getRouters()) router->wakeup();
-        while (!event_queue->is_empty() &&
-               event_queue->peek_next_time() <= t) {
-            Event* ev = event_queue->get_next_event();
-            ev->get_obj()->wakeup();
-            delete ev;
-        }
-    }
+    SimKernel kernel(&network, topo->getNIs(), topo->getRouters(),
+                     config.kernel_mode, config.threads);
+    Measurement m = run_measurement(config, kernel, topo->getTGs(),
+                                    topo->getLinks());
 
     // Collect merged statistics from all TGs
     LatHist merged_hist;
@@ -544,12 +825,71 @@ static void run_uniform(const SimConfig& config, Topology* topo,
 
     write_uniform_json(config.pace_output, merged_hist,
                        total_packets, total_flits, total_latency, total_injected,
-                       t, topo->getLinks(),
+                       m.cycles(), topo->getLinks(),
                        "uniform", topo_id, config.inter_latency, config.inter_width,
-                       benchmark, 1.0);
+                       benchmark, 1.0, nullptr, &m);
+    std::cout << "Uniform: latency 95% CI +/- " << m.batches.ci95()
+              << " cycles over " << m.batches.n << " batches\n";
+    print_wakeup_stats(event_queue);
 }
 
 // ---- PACE simulation ----
+// ---- Checkpoints ----
+
+// Options that determine the network and the PACE workload; a checkpoint
+// only restores into a run with the same ones.
+static std::string checkpoint_config(const SimConfig& config) {
+    std::ostringstream s;
+    s << std::setprecision(17)
+      << "topology=" << config.topology << " rows=" << config.num_rows
+      << " cols=" << config.num_cols << " depth=" << config.num_depth
+      << " cpus=" << config.num_cpus << " vcs=" << config.vcs_per_vnet
+      << " routing=" << config.routing_algorithm
+      << " fault_model=" << config.enable_fault_model
+      << " chiplets=" << config.num_chiplets << " intra=" << config.intra_rows
+      << "x" << config.intra_cols << " inter=" << config.inter_topology
+      << "/" << config.inter_latency << "/" << config.inter_width
+      << " profile=" << config.pace_profile << " seed=" << config.seed
+      << " mshr=" << config.pace_mshr_limit
+      << " dir_routers=" << config.pace_dir_routers
+      << " packets_per_node=" << config.pace_packets_per_node
+      << " temporal_floor=" << config.pace_temporal_floor
+      << " ablation=" << config.pace_no_per_source << config.pace_no_phases
+      << config.pace_no_mshr << config.pace_no_remap
+      << config.pace_no_weighted_dest << config.pace_no_corr_response
+      << config.pace_no_burst;
+    return s.str();
+}
+
+static std::string checkpoint_path(const SimConfig& config) {
+    if (!config.checkpoint_file.empty()) return config.checkpoint_file;
+    std::string base = config.pace_output;
+    if (base.size() > 5 && base.substr(base.size()-5) == ".json")
+        base = base.substr(0, base.size()-5);
+    return base + ".ckpt";
+}
+
+// Writes to a temporary file first, so a crash while writing keeps the
+// previous checkpoint intact.
+static void write_checkpoint(const SimConfig& config, uint64_t cycle,
+                             const Topology* topo, const PaceAdapter& adapter) {
+    std::string path = checkpoint_path(config);
+    std::string tmp = path + ".tmp";
+    bool ok;
+    {
+        CheckpointOut cp(tmp, cycle, checkpoint_config(config));
+        topo->saveState(cp);
+        adapter.saveState(cp);
+        ok = cp.ok();
+    }
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::cerr << "WARNING: could not write checkpoint " << path << "\n";
+        std::remove(tmp.c_str());
+        return;
+    }
+    std::cout << "Checkpoint at cycle " << cycle << " written to " << path << "\n";
+}
+
 static void run_pace(const SimConfig& config, Topology* topo,
                      GarnetNetwork& network)
 {
@@ -584,43 +924,386 @@ static void run_pace(const SimConfig& config, Topology* topo,
 
     for (auto router : topo->getRouters()) router->init();
 
-    EventQueue* event_queue = network.getEventQueue();
     uint64_t t = 0;
+    if (!config.restore_path.empty()) {
+        CheckpointIn cp(config.restore_path);
+        if (cp.ok() && cp.config() != checkpoint_config(config))
+            cp.fail("checkpoint was taken with different simulation options");
+        if (cp.ok()) {
+            topo->loadState(cp);
+            adapter.loadState(cp);
+        }
+        if (!cp.ok()) {
+            std::cerr << "ERROR: cannot restore " << config.restore_path
+                      << ": " << cp.error() << "\n";
+            std::exit(1);
+        }
+        t = cp.cycle();
+        std::cout << "Restored checkpoint " << config.restore_path
+                  << " at cycle " << t << "\n";
+    }
+    uint64_t start = t;
 
+    EventQueue* event_queue = network.getEventQueue();
+    auto make_kernel = [&]() {
+        return std::unique_ptr<SimKernel>(
+            new SimKernel(&network, topo->getNIs(), topo->getRouters(),
+                          config.kernel_mode, config.threads));
+    };
+    std::unique_ptr<SimKernel> kernel = make_kernel();
+
+    // The adapter advances its phases once per cycle, so no fast-forward
+    // until the drain window.  A checkpoint holds the state at the start
+    // of a cycle, before the adapter's tick.
     for (; t < 1000000000; ++t) {
-        event_queue->set_current_time(t);
-        if (t > 0 && !adapter.tick(t)) break;
-        for (auto ni : topo->getNIs())         ni->wakeup();
-        for (auto router : topo->getRouters()) router->wakeup();
-        while (!event_queue->is_empty() &&
-               event_queue->peek_next_time() <= t) {
-            Event* ev = event_queue->get_next_event();
-            ev->get_obj()->wakeup();
-            delete ev;
+        if (config.checkpoint_every > 0 && t > start &&
+            t % config.checkpoint_every == 0) {
+            // Hand all state back to the network; the old kernel has to be
+            // gone before the next one partitions the network again.
+            kernel->finish(t);
+            kernel.reset();
+            write_checkpoint(config, t, topo, adapter);
+            kernel = make_kernel();
         }
+        if (t > 0 && !adapter.tick(t)) break;
+        kernel->run(t, t + 1);
     }
 
     // Drain window
     uint64_t drain_cycles = 200;
-    for (uint64_t d = 0; d < drain_cycles; ++d, ++t) {
-        event_queue->set_current_time(t);
-        for (auto ni : topo->getNIs())         ni->wakeup();
-        for (auto router : topo->getRouters()) router->wakeup();
-        while (!event_queue->is_empty() &&
-               event_queue->peek_next_time() <= t) {
-            Event* ev = event_queue->get_next_event();
-            ev->get_obj()->wakeup();
-            delete ev;
-        }
-    }
+    uint64_t end = t + drain_cycles;
+    kernel->run(t, end);
+    t = end;
+    kernel->finish(t);
 
     adapter.dump_results(config.pace_output, topo->getLinks(), t);
+    print_wakeup_stats(event_queue);
     std::cout << "PACE simulation finished.\n";
 }
 
+// ---- Network construction ----
+
+// PACE mode: profile given and not forced to uniform.
+static bool is_pace_mode(const SimConfig& config) {
+    return !config.pace_profile.empty() && !config.uniform_mode &&
+           (config.synthetic.empty() || config.synthetic == "pace");
+}
+
+// Profile-aware uniform: --uniform with a profile file.
+static bool is_uniform_with_profile(const SimConfig& config) {
+    return config.uniform_mode && !config.pace_profile.empty();
+}
+
+// A network and the topology built on it (destroyed first).
+struct SimInstance {
+    std::unique_ptr<GarnetNetwork> network;
+    std::unique_ptr<Topology>      topo;
+};
+
+static SimInstance build_network(const SimConfig& config) {
+    GarnetNetwork::Params net_params;
+    net_params.num_rows          = config.num_rows;
+    net_params.num_cols          = config.num_cols;
+    net_params.num_depth         = config.num_depth;
+    net_params.ni_flit_size      = 16;
+    net_params.vcs_per_vnet      = config.vcs_per_vnet;
+    net_params.buffers_per_data_vc = 4;
+    net_params.buffers_per_ctrl_vc = 1;
+    net_params.routing_algorithm = config.routing_algorithm;
+    net_params.enable_fault_model = config.enable_fault_model;
+    net_params.enable_debug      = config.debug;
+    net_params.generic_router_kernels = config.generic_router_kernels;
+
+    SimInstance sim;
+    sim.network.reset(new GarnetNetwork(net_params));
+
+    TopologyParams tparams;
+    tparams.num_chiplets   = config.num_chiplets;
+    tparams.intra_rows     = config.intra_rows;
+    tparams.intra_cols     = config.intra_cols;
+    tparams.inter_topology = config.inter_topology;
+    tparams.inter_latency  = config.inter_latency;
+    tparams.inter_width    = config.inter_width;
+    tparams.vcs_per_vnet   = config.vcs_per_vnet;
+    tparams.num_cpus       = config.num_cpus;
+
+    sim.topo.reset(Topology::create(config.topology, sim.network.get(),
+                                    config.num_rows, config.num_cols,
+                                    config.num_depth, tparams));
+
+    // PACE mode needs 3 vnets; uniform with profile also uses 3 for compatibility.
+    if (is_pace_mode(config) || is_uniform_with_profile(config))
+        sim.topo->set_num_vnets(3);
+    // PACE requests (vnet 0) and writeback notifications (vnet 2) are
+    // single-flit control messages; their VCs get the control depth.
+    if (is_pace_mode(config)) {
+        sim.network->set_vnet_type(0, CTRL_VNET_);
+        sim.network->set_vnet_type(2, CTRL_VNET_);
+    }
+    sim.topo->set_vcs_per_vnet(config.vcs_per_vnet);
+
+    sim.topo->build();
+    sim.network->init();
+    std::cout << "Routing tables: " << sim.network->getRoutingTableBytes()
+              << " bytes compiled for " << sim.topo->getRouters().size()
+              << " routers\n";
+    if (!sim.topo->getRouters().empty())
+        std::cout << "Router state: "
+                  << sim.topo->getRouterBytes() / sim.topo->getRouters().size()
+                  << " bytes per router\n";
+    return sim;
+}
+
+// ---- Parallel sweep jobs ----
+
+// While a job runs on a worker thread, everything that thread writes to
+// std::cout goes to the job's log.  run_jobs() prints the logs in job order,
+// so the console reads as if the jobs had run one after another.
+class JobLogBuf : public std::streambuf {
+  public:
+    explicit JobLogBuf(std::streambuf* out) : m_out(out) {}
+
+    static std::string*& thread_log() {
+        static thread_local std::string* log = nullptr;
+        return log;
+    }
+
+  protected:
+    int overflow(int c) override {
+        if (c == traits_type::eof()) return traits_type::not_eof(c);
+        if (thread_log()) { thread_log()->push_back((char)c); return c; }
+        return m_out->sputc((char)c);
+    }
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        if (thread_log()) { thread_log()->append(s, n); return n; }
+        return m_out->sputn(s, n);
+    }
+    int sync() override { return thread_log() ? 0 : m_out->pubsync(); }
+
+  private:
+    std::streambuf* m_out;
+};
+
+// Runs job(0) .. job(count-1) on up to `jobs` threads.
+static void run_jobs(int jobs, int count, const std::function<void(int)>& job) {
+    if (jobs <= 1 || count <= 1) {
+        for (int i = 0; i < count; ++i) job(i);
+        return;
+    }
+
+    JobLogBuf log_buf(std::cout.rdbuf());
+    std::streambuf* console = std::cout.rdbuf(&log_buf);
+
+    std::vector<std::string> logs(count);
+    std::vector<bool> done(count, false);
+    std::mutex mutex;
+    std::condition_variable job_done;
+    std::atomic<int> next_job(0);
+
+    std::vector<std::thread> workers;
+    for (int w = 0; w < std::min(jobs, count); ++w) {
+        workers.emplace_back([&]() {
+            for (int i = next_job++; i < count; i = next_job++) {
+                JobLogBuf::thread_log() = &logs[i];
+                job(i);
+                JobLogBuf::thread_log() = nullptr;
+                std::lock_guard<std::mutex> lock(mutex);
+                done[i] = true;
+                job_done.notify_one();
+            }
+        });
+    }
+
+    for (int i = 0; i < count; ++i) {
+        std::unique_lock<std::mutex> lock(mutex);
+        job_done.wait(lock, [&]() { return (bool)done[i]; });
+        lock.unlock();
+        std::cout << logs[i] << std::flush;
+        std::string().swap(logs[i]);
+    }
+    for (auto& worker : workers) worker.join();
+    std::cout.rdbuf(console);
+}
+
+// Runs branch(0) .. branch(count-1), each in a child process fork()ed from
+// the current simulation state, at most `jobs` at a time.  Children see a
+// copy-on-write image of the parent, so every branch continues from the
+// same state without having to copy or rebuild it.  A child's console
+// output is captured and printed in branch order; whatever it writes to
+// `out` is returned (empty if the branch failed).  No other threads may be
+// running when this is called.
+static std::vector<std::string>
+run_forked_branches(int jobs, int count,
+                    const std::function<void(int, std::FILE*)>& branch)
+{
+    struct Child {
+        pid_t pid = -1;
+        std::FILE* log = nullptr;
+        std::FILE* out = nullptr;
+        bool done = false;
+    };
+    auto slurp = [](std::FILE* f) {
+        std::string text;
+        char buf[4096];
+        size_t n;
+        std::rewind(f);
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+        std::fclose(f);
+        return text;
+    };
+
+    std::vector<Child> children(count);
+    std::vector<std::string> results(count);
+    int launched = 0, running = 0, printed = 0;
+    while (printed < count) {
+        while (launched < count && running < jobs) {
+            Child& child = children[launched];
+            child.log = std::tmpfile();
+            child.out = std::tmpfile();
+            if (!child.log || !child.out) {
+                std::perror("tmpfile");
+                std::exit(1);
+            }
+            std::cout.flush();
+            std::fflush(nullptr);
+            child.pid = fork();
+            if (child.pid < 0) {
+                std::perror("fork");
+                std::exit(1);
+            }
+            if (child.pid == 0) {
+                dup2(fileno(child.log), STDOUT_FILENO);
+                branch(launched, child.out);
+                std::cout.flush();
+                std::fflush(nullptr);
+                _exit(0);
+            }
+            ++launched;
+            ++running;
+        }
+
+        int status = 0;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            std::perror("wait");
+            std::exit(1);
+        }
+        for (int i = 0; i < launched; ++i) {
+            if (children[i].pid != pid) continue;
+            children[i].done = true;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cerr << "ERROR: forked run " << i << " failed\n";
+                std::fclose(children[i].out);
+                children[i].out = nullptr;
+            }
+            --running;
+        }
+
+        for (; printed < count && children[printed].done; ++printed) {
+            std::cout << slurp(children[printed].log) << std::flush;
+            if (children[printed].out)
+                results[printed] = slurp(children[printed].out);
+        }
+    }
+    return results;
+}
+
+// ---- Sweep helpers ----
+
+// Seed offset between replications of the same sweep point.  Replication 0
+// uses the seeds a single-seed sweep always used.  Every NI of a run gets
+// the same seed: the NI id is part of each CounterRng key already.
+static const int kReplicaSeedStride = 10007;
+
+// One (point, seed) run of a sweep.
+struct SweepRun {
+    std::string json;          // per-run results JSON
+    double avg_latency = 0.0;
+    double p99_latency = 0.0;
+    double throughput  = 0.0;  // flits/cycle
+};
+
+static std::string sweep_point_path(const std::string& base, double mult,
+                                    int replica) {
+    std::ostringstream path;
+    path << base << "_sweep_" << std::fixed << std::setprecision(2) << mult;
+    if (replica > 0) path << "_seed" << replica;
+    path << ".json";
+    return path.str();
+}
+
+// Adds the mean and 95% CI across a point's seeds (runs[0..seeds-1]) to the
+// first seed's JSON, rewrites the point file with it and prints a summary.
+static std::string add_seed_stats(const SweepRun* runs, int seeds,
+                                  const std::string& path,
+                                  const std::string& label) {
+    SampleStats lat, p99, thr;
+    for (int r = 0; r < seeds; ++r) {
+        lat.add(runs[r].avg_latency);
+        p99.add(runs[r].p99_latency);
+        thr.add(runs[r].throughput);
+    }
+
+    std::ostringstream block;
+    block << std::fixed << std::setprecision(6)
+          << ",\n  \"seed_stats\": {\n"
+          << "    \"num_seeds\": " << seeds << ",\n"
+          << "    \"avg_packet_latency_mean\": " << lat.mean() << ",\n"
+          << "    \"avg_packet_latency_ci95\": " << lat.ci95() << ",\n"
+          << "    \"p99_latency_mean\": "        << p99.mean() << ",\n"
+          << "    \"p99_latency_ci95\": "        << p99.ci95() << ",\n"
+          << "    \"throughput_flits_per_cycle_mean\": " << thr.mean() << ",\n"
+          << "    \"throughput_flits_per_cycle_ci95\": " << thr.ci95() << "\n"
+          << "  }";
+
+    std::string json = runs[0].json;
+    size_t close = json.rfind("\n}");
+    if (close == std::string::npos) return json;
+    json.insert(close, block.str());
+    std::ofstream(path) << json;
+
+    std::cout << label << ": " << seeds << " seeds"
+              << "  avg_lat=" << lat.mean() << " +/- " << lat.ci95()
+              << "  p99=" << p99.mean() << " +/- " << p99.ci95()
+              << "  throughput=" << thr.mean() << " +/- " << thr.ci95()
+              << " flits/cycle\n";
+    return json;
+}
+
+// Writes the combined sweep JSON from the points' results.
+static bool write_sweep_json(const std::string& path,
+                             const std::string& benchmark,
+                             const std::string& topo_id,
+                             const std::string& method,
+                             double base_lambda,
+                             const std::vector<std::string>& points) {
+    std::ofstream sf(path);
+    if (!sf.is_open()) return false;
+    sf << "{\n"
+       << "  \"benchmark\": \"" << benchmark << "\",\n"
+       << "  \"topo_id\": \"" << topo_id << "\",\n"
+       << "  \"method\": \"" << method << "\",\n"
+       << "  \"sweep_type\": \"lambda\",\n"
+       << "  \"base_lambda\": " << base_lambda << ",\n"
+       << "  \"sweep_results\": [\n";
+    bool first = true;
+    for (const auto& point : points) {
+        size_t s = point.find('{');
+        size_t e = point.rfind('}');
+        if (s == std::string::npos || e == std::string::npos) continue;
+        if (!first) sf << ",\n";
+        sf << "    " << point.substr(s, e - s + 1);
+        first = false;
+    }
+    if (!first) sf << "\n";
+    sf << "  ]\n}\n";
+    return true;
+}
+
 // ---- Sweep mode: run PACE simulation for each lambda multiplier ----
-static void run_sweep(const SimConfig& config, Topology* topo,
-                      GarnetNetwork& network,
+// Every (point, seed) run builds its own network, so no router, VC or link
+// state carries over between points; --jobs runs them concurrently.
+static void run_sweep(const SimConfig& config,
                       const std::vector<double>& multipliers)
 {
     PaceAdapter::AblationConfig ablation;
@@ -633,7 +1316,7 @@ static void run_sweep(const SimConfig& config, Topology* topo,
     ablation.no_burst         = config.pace_no_burst;
 
     // Peek at profile for metadata to embed in combined sweep file
-    PaceProfile peek = PaceProfile::load(config.pace_profile);
+    const PaceProfile& peek = *PaceProfile::shared(config.pace_profile);
     std::string benchmark = peek.benchmark.empty() ? "unknown" : peek.benchmark;
     std::string topo_id   = config.topo_id.empty() ? peek.topo_id : config.topo_id;
 
@@ -641,15 +1324,24 @@ static void run_sweep(const SimConfig& config, Topology* topo,
     if (base.size() > 5 && base.substr(base.size()-5) == ".json")
         base = base.substr(0, base.size()-5);
 
-    std::vector<std::string> point_files;
+    int seeds = config.seeds;
+    std::vector<SweepRun> runs(multipliers.size() * seeds);
 
-    for (int mi = 0; mi < (int)multipliers.size(); ++mi) {
+    run_jobs(config.jobs, (int)runs.size(), [&](int run) {
+        int mi = run / seeds, replica = run % seeds;
         double mult = multipliers[mi];
         std::cout << "\n=== SWEEP point " << mi+1 << "/" << multipliers.size()
-                  << "  lambda_mult=" << mult << " ===\n";
+                  << "  lambda_mult=" << mult;
+        if (seeds > 1) std::cout << "  seed " << replica+1 << "/" << seeds;
+        std::cout << " ===\n";
+
+        SimInstance sim = build_network(config);
+        Topology* topo = sim.topo.get();
+        GarnetNetwork& network = *sim.network;
 
         PaceAdapter adapter(config.pace_profile, config.pace_mshr_limit,
-                            config.seed + mi, ablation,
+                            config.seed + mi + replica * kReplicaSeedStride,
+                            ablation,
                             config.pace_packets_per_node,
                             config.pace_temporal_floor);
         adapter.scale_lambda(mult);
@@ -669,77 +1361,56 @@ static void run_sweep(const SimConfig& config, Topology* topo,
             tg->set_trace_packet(config.trace_packet);
         for (auto router : topo->getRouters()) router->init();
 
-        EventQueue* event_queue = network.getEventQueue();
+        SimKernel kernel(&network, topo->getNIs(), topo->getRouters(),
+                         config.kernel_mode, config.threads);
         uint64_t t = 0;
         for (; t < 1000000000; ++t) {
-            event_queue->set_current_time(t);
             if (t > 0 && !adapter.tick(t)) break;
-            for (auto ni : topo->getNIs())         ni->wakeup();
-            for (auto router : topo->getRouters()) router->wakeup();
-            while (!event_queue->is_empty() &&
-                   event_queue->peek_next_time() <= t) {
-                Event* ev = event_queue->get_next_event();
-                ev->get_obj()->wakeup();
-                delete ev;
-            }
+            kernel.run(t, t + 1);
         }
         uint64_t drain = 200 + (uint64_t)(10 * topo->get_diameter());
-        for (uint64_t d = 0; d < drain; ++d, ++t) {
-            event_queue->set_current_time(t);
-            for (auto ni : topo->getNIs())         ni->wakeup();
-            for (auto router : topo->getRouters()) router->wakeup();
-            while (!event_queue->is_empty() &&
-                   event_queue->peek_next_time() <= t) {
-                Event* ev = event_queue->get_next_event();
-                ev->get_obj()->wakeup();
-                delete ev;
-            }
+        uint64_t end = t + drain;
+        kernel.run(t, end);
+        t = end;
+        kernel.finish(t);
+
+        SweepRun& result = runs[run];
+        adapter.dump_results_with_multiplier(sweep_point_path(base, mult, replica),
+                                             topo->getLinks(), t, mult,
+                                             &result.json);
+        uint64_t packets = adapter.get_total_packets_received();
+        result.avg_latency = packets > 0
+            ? (double)adapter.get_total_latency_sum() / packets : 0.0;
+        result.p99_latency = adapter.get_lat_hist().percentile(0.99);
+        result.throughput  = (double)adapter.get_total_flits_received() / t;
+    });
+
+    std::vector<std::string> points;
+    for (int mi = 0; mi < (int)multipliers.size(); ++mi) {
+        const SweepRun* first = &runs[mi * seeds];
+        if (seeds == 1) {
+            points.push_back(first->json);
+            continue;
         }
-
-        std::ostringstream pt_path;
-        pt_path << base << "_sweep_" << std::fixed << std::setprecision(2) << mult << ".json";
-        std::string pt = pt_path.str();
-        adapter.dump_results_with_multiplier(pt, topo->getLinks(), t, mult);
-        point_files.push_back(pt);
+        std::ostringstream label;
+        label << "SWEEP point " << mi+1 << " lambda_mult=" << multipliers[mi];
+        points.push_back(add_seed_stats(first, seeds,
+                                        sweep_point_path(base, multipliers[mi], 0),
+                                        label.str()));
     }
 
     // Write combined sweep JSON
     std::string sweep_path = base + "_sweep.json";
-    std::ofstream sf(sweep_path);
-    if (sf.is_open()) {
-        sf << "{\n"
-           << "  \"benchmark\": \"" << benchmark << "\",\n"
-           << "  \"topo_id\": \"" << topo_id << "\",\n"
-           << "  \"method\": \"pace\",\n"
-           << "  \"sweep_type\": \"lambda\",\n"
-           << "  \"base_lambda\": " << peek.effective_lambda << ",\n"
-           << "  \"sweep_results\": [\n";
-        for (int mi = 0; mi < (int)point_files.size(); ++mi) {
-            std::ifstream pf(point_files[mi]);
-            if (pf.is_open()) {
-                std::string content((std::istreambuf_iterator<char>(pf)),
-                                     std::istreambuf_iterator<char>());
-                size_t s = content.find('{');
-                size_t e = content.rfind('}');
-                if (s != std::string::npos && e != std::string::npos)
-                    content = content.substr(s, e - s + 1);
-                sf << "    " << content;
-                if (mi + 1 < (int)point_files.size()) sf << ",";
-                sf << "\n";
-            }
-        }
-        sf << "  ]\n}\n";
-        sf.close();
+    if (write_sweep_json(sweep_path, benchmark, topo_id, "pace",
+                         peek.effective_lambda, points))
         std::cout << "PACE sweep: combined results written to " << sweep_path << "\n";
-    }
 }
 
 // ---- Profile-aware uniform sweep ----
-static void run_uniform_sweep(const SimConfig& config, Topology* topo,
-                               GarnetNetwork& network,
+static void run_uniform_sweep(const SimConfig& config,
                                const std::vector<double>& multipliers)
 {
-    PaceProfile profile = PaceProfile::load(config.pace_profile);
+    const PaceProfile& profile = *PaceProfile::shared(config.pace_profile);
 
     double base_lambda = profile.effective_lambda;
     if (base_lambda <= 0.0) base_lambda = config.injection_rate;
@@ -752,7 +1423,6 @@ static void run_uniform_sweep(const SimConfig& config, Topology* topo,
     double fpp = (pkt_sum > 0) ? fpp_sum / pkt_sum : 1.0;
     int packet_size = std::max(1, (int)std::round(fpp));
 
-    int num_nis = (int)topo->getNIs().size();
     std::string benchmark = profile.benchmark.empty() ? "unknown" : profile.benchmark;
     std::string topo_id   = config.topo_id.empty() ? profile.topo_id : config.topo_id;
 
@@ -760,171 +1430,611 @@ static void run_uniform_sweep(const SimConfig& config, Topology* topo,
     if (base_out.size() > 5 && base_out.substr(base_out.size()-5) == ".json")
         base_out = base_out.substr(0, base_out.size()-5);
 
-    std::vector<std::string> point_files;
+    int seeds = config.seeds;
+    std::vector<SweepRun> runs(multipliers.size() * seeds);
 
-    for (int mi = 0; mi < (int)multipliers.size(); ++mi) {
-        double mult   = multipliers[mi];
-        double lambda = base_lambda * mult;
+    auto announce = [&](int mi, int replica) {
+        double mult = multipliers[mi];
         std::cout << "\n=== UNIFORM SWEEP point " << mi+1 << "/" << multipliers.size()
-                  << "  lambda_mult=" << mult << "  lambda=" << lambda << " ===\n";
+                  << "  lambda_mult=" << mult << "  lambda=" << base_lambda * mult;
+        if (seeds > 1) std::cout << "  seed " << replica+1 << "/" << seeds;
+        std::cout << " ===\n";
+    };
 
-        // Create fresh TGs for this sweep point (clean histograms per point).
-        std::vector<SimpleTrafficGenerator*> sweep_tgs;
+    // Creates fresh TGs for a sweep run (clean histograms per point).
+    auto make_tgs = [&](SimInstance& sim, int mi, int replica) {
+        Topology* topo = sim.topo.get();
+        int num_nis = (int)topo->getNIs().size();
+        std::vector<SimpleTrafficGenerator*> tgs;
         for (int i = 0; i < num_nis; ++i) {
             NetworkInterface* ni = topo->getNIs()[i];
-            auto* tg = new SimpleTrafficGenerator(i, num_nis, lambda, &network, ni);
+            auto* tg = new SimpleTrafficGenerator(i, num_nis,
+                                                  base_lambda * multipliers[mi],
+                                                  sim.network.get(), ni);
             tg->set_packet_size(packet_size);
-            tg->set_seed(config.seed + mi * 100 + i);
+            tg->set_seed(config.seed + replica * kReplicaSeedStride + mi * 100);
             tg->set_active(false);
             ni->setTrafficGenerator(tg);
-            sweep_tgs.push_back(tg);
-        }
-
-        for (auto router : topo->getRouters()) router->init();
-
-        EventQueue* event_queue = network.getEventQueue();
-        uint64_t t = 0;
-        for (; t <= (uint64_t)config.sim_cycles; ++t) {
-            event_queue->set_current_time(t);
-            for (auto ni : topo->getNIs())         ni->wakeup();
-            for (auto router : topo->getRouters()) router->wakeup();
-            while (!event_queue->is_empty() &&
-                   event_queue->peek_next_time() <= t) {
-                Event* ev = event_queue->get_next_event();
-                ev->get_obj()->wakeup();
-                delete ev;
-            }
+            tgs.push_back(tg);
         }
+        return tgs;
+    };
 
+    // Writes a run's point file; `cycles` is its measured length.
+    auto collect = [&](const std::vector<SimpleTrafficGenerator*>& tgs,
+                       Topology* topo, int mi, int replica, uint64_t cycles) {
         LatHist merged;
         uint64_t tot_lat = 0, tot_pkt = 0, tot_inj = 0;
-        for (auto* tg : sweep_tgs) {
+        for (auto* tg : tgs) {
             merged.merge(tg->get_lat_hist());
             tot_lat += tg->get_total_latency();
             tot_pkt += tg->get_received_packets();
             tot_inj += tg->get_injected_packets();
         }
         uint64_t tot_flt = tot_pkt * (uint64_t)packet_size;
-        uint64_t cycles_this = t;
+        double mult = multipliers[mi];
 
-        std::ostringstream pt_path;
-        pt_path << base_out << "_sweep_" << std::fixed << std::setprecision(2) << mult << ".json";
-        std::string pt = pt_path.str();
-        write_uniform_json(pt, merged, tot_pkt, tot_flt, tot_lat, tot_inj,
-                           cycles_this, topo->getLinks(),
+        SweepRun result;
+        write_uniform_json(sweep_point_path(base_out, mult, replica),
+                           merged, tot_pkt, tot_flt, tot_lat, tot_inj,
+                           cycles, topo->getLinks(),
                            "uniform", topo_id, config.inter_latency, config.inter_width,
-                           benchmark, mult);
-        point_files.push_back(pt);
-        for (auto* tg : sweep_tgs) delete tg;
+                           benchmark, mult, &result.json);
+        result.avg_latency = tot_pkt > 0 ? (double)tot_lat / tot_pkt : 0.0;
+        result.p99_latency = merged.percentile(0.99);
+        result.throughput  = (double)tot_flt / cycles;
+        return result;
+    };
+
+    uint64_t measure = (uint64_t)config.sim_cycles + 1;
+    if (config.fork_warmup == 0) {
+        run_jobs(config.jobs, (int)runs.size(), [&](int run) {
+            int mi = run / seeds, replica = run % seeds;
+            announce(mi, replica);
+
+            SimInstance sim = build_network(config);
+            Topology* topo = sim.topo.get();
+            std::vector<SimpleTrafficGenerator*> sweep_tgs =
+                make_tgs(sim, mi, replica);
+            for (auto router : topo->getRouters()) router->init();
+
+            SimKernel kernel(sim.network.get(), topo->getNIs(), topo->getRouters(),
+                             config.kernel_mode, config.threads);
+            kernel.run(0, measure);
+            kernel.finish(measure);
+
+            runs[run] = collect(sweep_tgs, topo, mi, replica, measure);
+            for (auto* tg : sweep_tgs) delete tg;
+        });
+    } else {
+        // Every point warms its own network up at its own rate (with the
+        // first replica's seeds), then forks a branch per replica that
+        // reseeds the generators and measures from the warmed-up state.
+        uint64_t warmup = config.fork_warmup;
+        for (int mi = 0; mi < (int)multipliers.size(); ++mi) {
+            SimInstance sim = build_network(config);
+            Topology* topo = sim.topo.get();
+            std::vector<SimpleTrafficGenerator*> sweep_tgs = make_tgs(sim, mi, 0);
+            // Packets are tagged when generated, so the warmup's traffic has
+            // to be left out before it is generated, as in run_measurement().
+            for (auto tg : sweep_tgs) tg->set_measure_window(warmup, warmup + measure);
+            for (auto router : topo->getRouters()) router->init();
+            {
+                // The kernel's worker threads must be gone before fork().
+                SimKernel kernel(sim.network.get(), topo->getNIs(), topo->getRouters(),
+                                 config.kernel_mode, config.threads);
+                kernel.run(0, warmup);
+                kernel.finish(warmup);
+            }
+            std::cout << "Uniform sweep: point " << mi+1 << " warmed up for "
+                      << warmup << " cycles, branching " << seeds << " runs\n";
+
+            std::vector<std::string> results = run_forked_branches(
+                config.jobs, seeds, [&](int replica, std::FILE* out) {
+                    announce(mi, replica);
+
+                    for (auto tg : sweep_tgs) {
+                        tg->set_seed(config.seed + replica * kReplicaSeedStride + mi * 100);
+                        tg->reset_stats();
+                    }
+                    for (auto link : topo->getLinks()) link->resetStats();
+
+                    SimKernel kernel(sim.network.get(), topo->getNIs(), topo->getRouters(),
+                                     config.kernel_mode, config.threads);
+                    kernel.run(warmup, warmup + measure);
+                    kernel.finish(warmup + measure);
+
+                    SweepRun result = collect(sweep_tgs, topo, mi, replica, measure);
+                    std::fprintf(out, "%a %a %a\n", result.avg_latency,
+                                 result.p99_latency, result.throughput);
+                    std::fputs(result.json.c_str(), out);
+                });
+
+            for (int replica = 0; replica < seeds; ++replica) {
+                std::istringstream in(results[replica]);
+                std::string line;
+                if (!std::getline(in, line)) continue;
+                SweepRun& result = runs[mi * seeds + replica];
+                std::sscanf(line.c_str(), "%la %la %la", &result.avg_latency,
+                            &result.p99_latency, &result.throughput);
+                result.json.assign(std::istreambuf_iterator<char>(in),
+                                   std::istreambuf_iterator<char>());
+            }
+            for (auto* tg : sweep_tgs) delete tg;
+        }
+    }
+
+    std::vector<std::string> points;
+    for (int mi = 0; mi < (int)multipliers.size(); ++mi) {
+        const SweepRun* first = &runs[mi * seeds];
+        if (seeds == 1) {
+            points.push_back(first->json);
+            continue;
+        }
+        std::ostringstream label;
+        label << "UNIFORM SWEEP point " << mi+1 << " lambda_mult=" << multipliers[mi];
+        points.push_back(add_seed_stats(first, seeds,
+                                        sweep_point_path(base_out, multipliers[mi], 0),
+                                        label.str()));
     }
 
     // Write combined sweep JSON
     std::string sweep_path = base_out + "_sweep.json";
-    std::ofstream sf(sweep_path);
-    if (sf.is_open()) {
-        sf << "{\n"
-           << "  \"benchmark\": \"" << benchmark << "\",\n"
-           << "  \"topo_id\": \"" << topo_id << "\",\n"
-           << "  \"method\": \"uniform\",\n"
-           << "  \"sweep_type\": \"lambda\",\n"
-           << "  \"base_lambda\": " << base_lambda << ",\n"
-           << "  \"sweep_results\": [\n";
-        for (int mi = 0; mi < (int)point_files.size(); ++mi) {
-            std::ifstream pf(point_files[mi]);
-            if (pf.is_open()) {
-                std::string content((std::istreambuf_iterator<char>(pf)),
-                                     std::istreambuf_iterator<char>());
-                size_t s = content.find('{');
-                size_t e = content.rfind('}');
-                if (s != std::string::npos && e != std::string::npos)
-                    content = content.substr(s, e - s + 1);
-                sf << "    " << content;
-                if (mi + 1 < (int)point_files.size()) sf << ",";
-                sf << "\n";
+    if (write_sweep_json(sweep_path, benchmark, topo_id, "uniform",
+                         base_lambda, points))
+        std::cout << "Uniform sweep: combined results written to " << sweep_path << "\n";
+}
+
+// ---- Saturation search ----
+
+// The zero-load latency is measured at this fraction of the base rate.
+static const double kZeroLoadMult = 0.05;
+// A probe diverges once its outstanding packets (queued at the source or
+// in flight) grew for kGrowthWindows windows in a row, by more than
+// kBacklogPerNode packets per node in total ...
+static const int    kGrowthWindows  = 4;
+static const double kBacklogPerNode = 2.0;
+// ... or a window's mean latency exceeds this multiple of zero-load.
+static const double kDivergedLatencyFactor = 10.0;
+// The knee is where the latency reaches this multiple of zero-load.
+static const double kKneeLatencyFactor = 2.0;
+// Bisection stops once the bracket is this narrow relative to its top.
+static const double kSaturationTolerance = 0.02;
+static const int    kMaxSaturationRounds = 12;
+// Highest multiple of the base rate tried (uniform generators also stop
+// at one packet per node and cycle).
+static const double kMaxSaturationMult = 1024.0;
+
+// Watches a probe window by window.  Below saturation the backlog and the
+// latency level off; above it they keep growing.
+class DivergenceMonitor {
+  public:
+    // No latency check if zero_load_latency is 0.
+    DivergenceMonitor(int nodes, double zero_load_latency)
+        : m_growth_limit(kBacklogPerNode * nodes),
+          m_latency_limit(kDivergedLatencyFactor * zero_load_latency) {}
+
+    // Takes the generators' totals at the end of a window; true once the
+    // probe has diverged.
+    bool update(uint64_t injected, uint64_t received, uint64_t latency_sum)
+    {
+        m_backlog = (int64_t)injected - (int64_t)received;
+        uint64_t packets = received - m_received;
+        if (m_latency_limit > 0 && packets > 0 &&
+            (double)(latency_sum - m_latency_sum) / packets > m_latency_limit)
+            m_diverged = true;
+        m_received = received;
+        m_latency_sum = latency_sum;
+
+        m_history.push_back(m_backlog);
+        if ((int)m_history.size() > kGrowthWindows + 1) m_history.pop_front();
+        if ((int)m_history.size() == kGrowthWindows + 1 &&
+            m_history.back() - m_history.front() > m_growth_limit &&
+            std::adjacent_find(m_history.begin(), m_history.end(),
+                               std::greater_equal<int64_t>()) ==
+                m_history.end())
+            m_diverged = true;
+        return m_diverged;
+    }
+
+    bool diverged() const { return m_diverged; }
+    int64_t backlog() const { return m_backlog; }
+
+  private:
+    double m_growth_limit;
+    double m_latency_limit;
+    std::deque<int64_t> m_history;   // backlog after the last windows
+    int64_t  m_backlog = 0;
+    uint64_t m_received = 0;
+    uint64_t m_latency_sum = 0;
+    bool     m_diverged = false;
+};
+
+// One injection rate tried by the search.
+struct SaturationProbe {
+    double   mult = 0.0;        // multiple of the base rate
+    bool     diverged = false;
+    uint64_t cycles = 0;        // simulated, up to the abort if diverged
+    double   avg_latency = 0.0;
+    double   throughput = 0.0;  // received flits/cycle
+    int64_t  backlog = 0;       // packets outstanding at the end
+};
+
+// Bisects on the injection rate for the highest one the network sustains.
+// PACE mode scales the profile's rates (scale_lambda); otherwise uniform
+// generators inject at --rate, or the profile's rate with --uniform.
+// Every probe builds its own network and is aborted as soon as it
+// diverges; --jobs probes run at once, splitting the bracket that many
+// ways per round.
+static void run_saturation_search(const SimConfig& config)
+{
+    bool pace = is_pace_mode(config);
+    std::string benchmark = "unknown";
+    std::string topo_id = config.topo_id;
+    double base_lambda = config.injection_rate;
+    int packet_size = config.packet_size;
+    if (!config.pace_profile.empty()) {
+        const PaceProfile& profile = *PaceProfile::shared(config.pace_profile);
+        if (!profile.benchmark.empty()) benchmark = profile.benchmark;
+        if (topo_id.empty()) topo_id = profile.topo_id;
+        if (profile.effective_lambda > 0.0) base_lambda = profile.effective_lambda;
+        if (!pace) {
+            double fpp_sum = 0.0; int64_t pkt_sum = 0;
+            for (const auto& ph : profile.phases) {
+                fpp_sum += ph.flits_per_packet * ph.total_packets;
+                pkt_sum += ph.total_packets;
             }
+            double fpp = (pkt_sum > 0) ? fpp_sum / pkt_sum : 1.0;
+            packet_size = std::max(1, (int)std::round(fpp));
         }
-        sf << "  ]\n}\n";
-        sf.close();
-        std::cout << "Uniform sweep: combined results written to " << sweep_path << "\n";
     }
+    if (base_lambda <= 0.0) {
+        std::cerr << "ERROR: --find-saturation needs a positive base rate\n";
+        std::exit(1);
+    }
+
+    PaceAdapter::AblationConfig ablation;
+    ablation.no_per_source    = config.pace_no_per_source;
+    ablation.no_phases        = config.pace_no_phases;
+    ablation.no_mshr          = config.pace_no_mshr;
+    ablation.no_remap         = config.pace_no_remap;
+    ablation.no_weighted_dest = config.pace_no_weighted_dest;
+    ablation.no_corr_response = config.pace_no_corr_response;
+    ablation.no_burst         = config.pace_no_burst;
+
+    uint64_t window = std::max<uint64_t>(50, (uint64_t)config.sim_cycles / 20);
+    double zero_load_latency = 0.0;
+
+    auto probe = [&](double mult) {
+        std::cout << "\n=== SATURATION probe lambda_mult=" << mult
+                  << "  lambda=" << base_lambda * mult << " ===\n";
+
+        SimInstance sim = build_network(config);
+        Topology* topo = sim.topo.get();
+        GarnetNetwork& network = *sim.network;
+        int num_nis = (int)topo->getNIs().size();
+
+        std::unique_ptr<PaceAdapter> adapter;
+        std::vector<TrafficGenerator*> tgs;
+        std::vector<std::unique_ptr<SimpleTrafficGenerator>> uniform_tgs;
+        if (pace) {
+            adapter.reset(new PaceAdapter(config.pace_profile,
+                                          config.pace_mshr_limit, config.seed,
+                                          ablation,
+                                          config.pace_packets_per_node,
+                                          config.pace_temporal_floor));
+            adapter->scale_lambda(mult);
+            adapter->set_topo_id(config.topo_id);
+            adapter->set_inter_config(config.inter_latency, config.inter_width);
+            if (!config.pace_dir_routers.empty()) {
+                std::vector<int> ids = parse_int_list(config.pace_dir_routers);
+                std::map<int,int> remap;
+                for (int d = 0; d < (int)ids.size(); ++d) remap[d] = ids[d];
+                adapter->set_directory_remapping(remap);
+            }
+            adapter->init(topo->getNIs(), &network, topo->get_diameter());
+            tgs.assign(adapter->getTGs().begin(), adapter->getTGs().end());
+        } else {
+            for (int i = 0; i < num_nis; ++i) {
+                NetworkInterface* ni = topo->getNIs()[i];
+                uniform_tgs.emplace_back(new SimpleTrafficGenerator(
+                    i, num_nis, base_lambda * mult, &network, ni));
+                SimpleTrafficGenerator* tg = uniform_tgs.back().get();
+                tg->set_packet_size(packet_size);
+                tg->set_seed(config.seed);
+                tg->set_active(false);
+                ni->setTrafficGenerator(tg);
+                tgs.push_back(tg);
+            }
+        }
+        for (auto router : topo->getRouters()) router->init();
+
+        DivergenceMonitor monitor(num_nis, zero_load_latency);
+        auto check = [&]() {
+            uint64_t injected = 0, received = 0, latency = 0;
+            for (auto tg : tgs) {
+                injected += tg->get_injected_packets();
+                received += tg->get_received_packets();
+                latency  += tg->get_total_latency();
+            }
+            return monitor.update(injected, received, latency);
+        };
+
+        SimKernel kernel(&network, topo->getNIs(), topo->getRouters(),
+                         config.kernel_mode, config.threads);
+        uint64_t t = 0;
+        if (pace) {
+            for (; t < 1000000000; ++t) {
+                if (t > 0 && t % window == 0 && check()) break;
+                if (t > 0 && !adapter->tick(t)) break;
+                kernel.run(t, t + 1);
+            }
+            if (!monitor.diverged()) {
+                uint64_t end = t + 200 + (uint64_t)(10 * topo->get_diameter());
+                kernel.run(t, end);
+                t = end;
+            }
+        } else {
+            uint64_t end = (uint64_t)config.sim_cycles + 1;
+            while (t < end) {
+                uint64_t next = std::min(end, t + window);
+                kernel.run(t, next);
+                t = next;
+                if (check()) break;
+            }
+        }
+        kernel.finish(t);
+
+        SaturationProbe result;
+        result.mult = mult;
+        result.diverged = monitor.diverged();
+        result.cycles = t;
+        result.backlog = monitor.backlog();
+        uint64_t packets = 0, latency = 0, flits = 0;
+        if (pace) {
+            packets = adapter->get_total_packets_received();
+            latency = adapter->get_total_latency_sum();
+            flits   = adapter->get_total_flits_received();
+        } else {
+            for (auto tg : tgs) {
+                packets += tg->get_received_packets();
+                latency += tg->get_total_latency();
+            }
+            flits = packets * (uint64_t)packet_size;
+        }
+        result.avg_latency = packets > 0 ? (double)latency / packets : 0.0;
+        result.throughput  = t > 0 ? (double)flits / t : 0.0;
+
+        if (result.diverged)
+            std::cout << "Saturation: diverged by cycle " << t
+                      << " (backlog " << result.backlog << " packets)\n";
+        else
+            std::cout << "Saturation: stable  avg_lat=" << result.avg_latency
+                      << "  throughput=" << result.throughput
+                      << " flits/cycle\n";
+        return result;
+    };
+
+    std::vector<SaturationProbe> probes;
+    auto run_probes = [&](const std::vector<double>& mults) {
+        std::vector<SaturationProbe> batch(mults.size());
+        run_jobs(config.jobs, (int)mults.size(),
+                 [&](int i) { batch[i] = probe(mults[i]); });
+        probes.insert(probes.end(), batch.begin(), batch.end());
+        return batch;
+    };
+
+    SaturationProbe zero = run_probes({kZeroLoadMult})[0];
+    if (zero.diverged || zero.avg_latency <= 0.0) {
+        std::cerr << "ERROR: --find-saturation could not measure the "
+                     "zero-load latency at " << kZeroLoadMult
+                  << "x the base rate; lower the base rate or run longer\n";
+        std::exit(1);
+    }
+    zero_load_latency = zero.avg_latency;
+
+    // Bracket: double the rate (config.jobs steps per round) until a probe
+    // diverges.  `lo` is the highest stable rate, `hi` the lowest diverged
+    // one (0 while none has).
+    double max_mult = kMaxSaturationMult;
+    if (!pace) max_mult = std::min(max_mult, 1.0 / base_lambda);
+    double lo = kZeroLoadMult, hi = 0.0;
+    for (double next = 1.0; hi == 0.0 && lo < max_mult; ) {
+        std::vector<double> mults;
+        while ((int)mults.size() < config.jobs) {
+            mults.push_back(std::min(next, max_mult));
+            next *= 2;
+            if (mults.back() >= max_mult) break;
+        }
+        for (const auto& p : run_probes(mults)) {
+            if (p.diverged) { hi = p.mult; break; }
+            lo = p.mult;
+        }
+    }
+
+    // Bisect: each round splits [lo, hi] into config.jobs + 1 parts.
+    for (int round = 0; hi > 0.0 && hi - lo > kSaturationTolerance * hi &&
+                        round < kMaxSaturationRounds; ++round) {
+        std::vector<double> mults;
+        for (int j = 1; j <= config.jobs; ++j)
+            mults.push_back(lo + (hi - lo) * j / (config.jobs + 1));
+        for (const auto& p : run_probes(mults)) {
+            if (p.diverged) { hi = p.mult; break; }
+            lo = p.mult;
+        }
+    }
+
+    // Stable probes up to the saturation point, by rate.
+    std::vector<SaturationProbe> curve;
+    for (const auto& p : probes)
+        if (!p.diverged && p.mult <= lo) curve.push_back(p);
+    std::sort(curve.begin(), curve.end(),
+              [](const SaturationProbe& a, const SaturationProbe& b) {
+                  return a.mult < b.mult;
+              });
+    const SaturationProbe& sat = curve.back();
+
+    // Knee: interpolate where the latency crosses the threshold.
+    double knee_latency = kKneeLatencyFactor * zero_load_latency;
+    double knee_mult = sat.mult, knee_throughput = sat.throughput;
+    if (sat.avg_latency < knee_latency) {
+        knee_latency = sat.avg_latency;
+    } else {
+        for (size_t i = 1; i < curve.size(); ++i) {
+            const SaturationProbe& a = curve[i - 1];
+            const SaturationProbe& b = curve[i];
+            if (b.avg_latency < knee_latency) continue;
+            double f = b.avg_latency > a.avg_latency
+                       ? (knee_latency - a.avg_latency) /
+                         (b.avg_latency - a.avg_latency)
+                       : 1.0;
+            f = std::max(0.0, std::min(1.0, f));
+            knee_mult = a.mult + f * (b.mult - a.mult);
+            knee_throughput = a.throughput + f * (b.throughput - a.throughput);
+            break;
+        }
+    }
+
+    bool saturated = hi > 0.0;
+    std::cout << "\nSaturation search: " << probes.size() << " probes\n"
+              << "  - Zero-load latency: " << zero_load_latency << " cycles\n";
+    if (saturated)
+        std::cout << "  - Saturation: lambda_mult " << sat.mult
+                  << " (diverges at " << hi << "), throughput "
+                  << sat.throughput << " flits/cycle\n";
+    else
+        std::cout << "  - No saturation up to lambda_mult " << sat.mult
+                  << ", throughput " << sat.throughput << " flits/cycle\n";
+    std::cout << "  - Knee: lambda_mult " << knee_mult << ", latency "
+              << knee_latency << " cycles, throughput " << knee_throughput
+              << " flits/cycle\n";
+
+    std::string base = config.pace_output;
+    if (base.size() > 5 && base.substr(base.size()-5) == ".json")
+        base = base.substr(0, base.size()-5);
+    std::string path = base + "_saturation.json";
+    std::ofstream jf(path);
+    if (!jf.is_open()) {
+        std::cerr << "ERROR: cannot write " << path << "\n";
+        return;
+    }
+    jf << std::fixed << std::setprecision(6)
+       << "{\n"
+       << "  \"benchmark\": \"" << benchmark << "\",\n"
+       << "  \"topo_id\": \"" << topo_id << "\",\n"
+       << "  \"method\": \"" << (pace ? "pace" : "uniform") << "\",\n"
+       << "  \"base_lambda\": " << base_lambda << ",\n"
+       << "  \"zero_load_latency\": " << zero_load_latency << ",\n"
+       << "  \"saturated\": " << (saturated ? "true" : "false") << ",\n"
+       << "  \"saturation_lambda_mult\": " << sat.mult << ",\n"
+       << "  \"saturation_lambda\": " << base_lambda * sat.mult << ",\n"
+       << "  \"saturation_throughput_flits_per_cycle\": " << sat.throughput << ",\n"
+       << "  \"diverged_lambda_mult\": " << hi << ",\n"
+       << "  \"knee_lambda_mult\": " << knee_mult << ",\n"
+       << "  \"knee_lambda\": " << base_lambda * knee_mult << ",\n"
+       << "  \"knee_latency\": " << knee_latency << ",\n"
+       << "  \"knee_throughput_flits_per_cycle\": " << knee_throughput << ",\n"
+       << "  \"probes\": [\n";
+    for (size_t i = 0; i < probes.size(); ++i) {
+        const SaturationProbe& p = probes[i];
+        jf << "    {\"lambda_mult\": " << p.mult
+           << ", \"lambda\": " << base_lambda * p.mult
+           << ", \"diverged\": " << (p.diverged ? "true" : "false")
+           << ", \"cycles\": " << p.cycles
+           << ", \"avg_packet_latency\": " << p.avg_latency
+           << ", \"throughput_flits_per_cycle\": " << p.throughput
+           << ", \"backlog_packets\": " << p.backlog << "}"
+           << (i + 1 < probes.size() ? ",\n" : "\n");
+    }
+    jf << "  ]\n}\n";
+    std::cout << "Saturation search: results written to " << path << "\n";
+}
+
+// ---- --compile-profile ----
+// Writes the profile, JSON or image, as an image that later runs decode
+// in one pass instead of parsing JSON (PaceProfile::save_image()).
+static void compile_profile(const SimConfig& config)
+{
+    if (config.pace_profile.empty()) {
+        std::cerr << "ERROR: --compile-profile needs --pace-profile\n";
+        std::exit(1);
+    }
+    const PaceProfile& profile = *PaceProfile::shared(config.pace_profile);
+    profile.save_image(config.compile_profile);
+    std::cout << "PACE: compiled \"" << config.pace_profile << "\" ("
+              << profile.phases.size() << " phases, "
+              << profile.num_cpus << " cpus, " << profile.num_dirs
+              << " dirs) to \"" << config.compile_profile << "\"\n";
 }
 
 int main(int argc, char** argv) {
     SimConfig config;
     parse_args(argc, argv, config);
 
-    // PACE mode: profile given and not forced to uniform.
-    bool pace_mode = !config.pace_profile.empty() && !config.uniform_mode &&
-                     (config.synthetic.empty() || config.synthetic == "pace");
+    if (!config.compile_profile.empty()) {
+        compile_profile(config);
+        return 0;
+    }
 
-    // Profile-aware uniform: --uniform with a profile file.
-    bool uniform_with_profile = config.uniform_mode && !config.pace_profile.empty();
+    bool pace_mode = is_pace_mode(config);
+    bool uniform_with_profile = is_uniform_with_profile(config);
 
     // Chiplet topologies require TABLE routing (algorithm=0).
     bool is_chiplet = (config.topology == "PACE_Chiplet" ||
                        config.topology == "PACE_Chiplet_CMesh");
     if (is_chiplet) config.routing_algorithm = 0;
 
-    GarnetNetwork::Params net_params;
-    net_params.num_rows          = config.num_rows;
-    net_params.num_cols          = config.num_cols;
-    net_params.num_depth         = config.num_depth;
-    net_params.ni_flit_size      = 16;
-    net_params.vcs_per_vnet      = config.vcs_per_vnet;
-    net_params.buffers_per_data_vc = 4;
-    net_params.buffers_per_ctrl_vc = 1;
-    net_params.routing_algorithm = config.routing_algorithm;
-    net_params.enable_fault_model = config.enable_fault_model;
-    net_params.enable_debug      = config.debug;
-
-    GarnetNetwork network(net_params);
-
-    TopologyParams tparams;
-    tparams.num_chiplets   = config.num_chiplets;
-    tparams.intra_rows     = config.intra_rows;
-    tparams.intra_cols     = config.intra_cols;
-    tparams.inter_topology = config.inter_topology;
-    tparams.inter_latency  = config.inter_latency;
-    tparams.inter_width    = config.inter_width;
-    tparams.vcs_per_vnet   = config.vcs_per_vnet;
-    tparams.num_cpus       = config.num_cpus;
-
-    Topology* topo = Topology::create(config.topology, &network,
-                                      config.num_rows, config.num_cols,
-                                      config.num_depth, tparams);
-
-    // PACE mode needs 3 vnets; uniform with profile also uses 3 for compatibility.
-    if (pace_mode || uniform_with_profile) topo->set_num_vnets(3);
-    topo->set_vcs_per_vnet(config.vcs_per_vnet);
-
-    topo->build();
-    network.init();
-
     std::vector<double> multipliers;
     if (!config.sweep_lambda_range.empty()) {
         multipliers = parse_sweep_range(config.sweep_lambda_range);
         if (multipliers.empty()) {
             std::cerr << "ERROR: --sweep-lambda-range produced no points: "
                       << config.sweep_lambda_range << "\n";
-            delete topo;
             return 1;
         }
     }
 
-    if (pace_mode && !multipliers.empty()) {
+    // PACE phases are timed from cycle 0, so a PACE run cannot start from
+    // another run's warmed-up state.
+    bool sweep = !multipliers.empty() && !config.find_saturation;
+    if (config.fork_warmup > 0 && !(uniform_with_profile && sweep))
+        std::cerr << "WARNING: --fork-warmup only applies to --uniform sweeps; ignored\n";
+    if ((config.checkpoint_every > 0 || !config.restore_path.empty()) &&
+        !(pace_mode && multipliers.empty() && !config.find_saturation))
+        std::cerr << "WARNING: --checkpoint-every/--restore only apply to "
+                     "single PACE runs; ignored\n";
+
+    if (config.find_saturation) {
+        if (!multipliers.empty())
+            std::cerr << "WARNING: --sweep-lambda-range is ignored with "
+                         "--find-saturation\n";
+        if (config.deterministic_test)
+            std::cerr << "WARNING: --test-mode is ignored with "
+                         "--find-saturation\n";
+        run_saturation_search(config);
+        return 0;
+    }
+
+    // Sweeps build a network per run.
+    if (pace_mode && sweep) {
         std::cout << "PACE sweep mode: " << multipliers.size() << " lambda multipliers\n";
-        run_sweep(config, topo, network, multipliers);
-    } else if (pace_mode) {
-        run_pace(config, topo, network);
-    } else if (uniform_with_profile && !multipliers.empty()) {
+        run_sweep(config, multipliers);
+        return 0;
+    }
+    if (uniform_with_profile && sweep) {
         std::cout << "Uniform sweep mode: " << multipliers.size() << " lambda multipliers\n";
-        run_uniform_sweep(config, topo, network, multipliers);
+        run_uniform_sweep(config, multipliers);
+        return 0;
+    }
+
+    SimInstance sim = build_network(config);
+    if (pace_mode) {
+        run_pace(config, sim.topo.get(), *sim.network);
     } else if (uniform_with_profile) {
-        run_uniform(config, topo, network);
+        run_uniform(config, sim.topo.get(), *sim.network);
     } else {
-        run_standard(config, topo, network);
+        run_standard(config, sim.topo.get(), *sim.network);
     }
 
-    delete topo;
     return 0;
 }